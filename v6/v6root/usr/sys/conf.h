@@ -71,6 +71,7 @@ struct	cdevsw
 	int	(*d_read)();
 	int	(*d_write)();
 	int	(*d_sgtty)();
+	int	(*d_select)();
 } cdevsw[];
 
 /*
@@ -633,6 +633,38 @@ _clearseg:
 	mov	(sp)+,PS
 	rts	pc
 
+/ pcopy(fromclick, fromoff, toclick, tooff, nwords)
+/ offsets and count must stay within 8K
+
+.globl	_pcopy
+_pcopy:
+	mov	PS,-(sp)
+	mov	UISA0,-(sp)
+	mov	UISA1,-(sp)
+	mov	$30340,PS
+	mov	10(sp),UISA0
+	mov	14(sp),UISA1
+	mov	UISD0,-(sp)
+	mov	UISD1,-(sp)
+	mov	$77406,UISD0
+	mov	$77406,UISD1
+	mov	r2,-(sp)
+	mov	20(sp),r0
+	mov	24(sp),r1
+	add	$8192.,r1
+	mov	26(sp),r2
+1:
+	mfpi	(r0)+
+	mtpi	(r1)+
+	sob	r2,1b
+	mov	(sp)+,r2
+	mov	(sp)+,UISD1
+	mov	(sp)+,UISD0
+	mov	(sp)+,UISA1
+	mov	(sp)+,UISA0
+	mov	(sp)+,PS
+	rts	pc
+
 .globl	_dpadd
 _dpadd:
 	mov	2(sp),r0
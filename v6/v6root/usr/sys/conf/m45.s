@@ -710,6 +710,32 @@ _clearseg:
 	mov	(sp)+,PS
 	rts	pc
 
+/ pcopy(fromclick, fromoff, toclick, tooff, nwords)
+/ offsets and count must stay within 8K
+
+.globl	_pcopy
+_pcopy:
+	mov	PS,-(sp)
+	mov	4(sp),SISA0
+	mov	10(sp),SISA1
+	mov	$10000+HIPRI,PS
+	mov	$77406,SISD0
+	mov	$77406,SISD1
+	mov	r2,-(sp)
+	mov	10(sp),r0
+	mov	14(sp),r1
+	add	$8192.,r1
+	mov	16(sp),r2
+1:
+	mfpd	(r0)+
+	mtpd	(r1)+
+	sob	r2,1b
+	mov	$6,SISD0
+	mov	$6,SISD1
+	mov	(sp)+,r2
+	mov	(sp)+,PS
+	rts	pc
+
 .globl	_dpadd
 _dpadd:
 	mov	2(sp),r0
@@ -14,6 +14,7 @@ char	*btab[]
 	"hs",
 	"hp",
 	"ht",
+	"rd",
 	0
 };
 char	*ctab[]
@@ -34,6 +35,8 @@ char	*ctab[]
 	"hs",
 	"hp",
 	"ht",
+	"kprof",
+	"rd",
 	0
 };
 struct tab
@@ -55,7 +58,7 @@ struct tab
 	".globl\t_klrint\nklin:\tjsr\tr0,call; _klrint\n",
 	".globl\t_klxint\nklou:\tjsr\tr0,call; _klxint\n",
 	"",
-	"\t&klopen,   &klclose,  &klread,   &klwrite,  &klsgtty,",
+	"\t&klopen,   &klclose,  &klread,   &klwrite,  &klsgtty,  &klselect,",
 
 	"mem",
 	-1,	300,	CHAR,
@@ -63,7 +66,23 @@ struct tab
 	"",
 	"",
 	"",
-	"\t&nulldev,  &nulldev,  &mmread,   &mmwrite,  &nodev,",
+	"\t&nulldev,  &nulldev,  &mmread,   &mmwrite,  &nodev,    &seltrue,",
+
+	"kprof",
+	-1,	300,	CHAR,
+	"",
+	"",
+	"",
+	"",
+	"\t&nulldev,  &nulldev,  &kpread,   &kpwrite,  &nodev,    &seltrue,",
+
+	"rd",
+	0,	300,	BLOCK+CHAR,
+	"",
+	"",
+	"",
+	"\t&rdopen,\t&nulldev,\t&rdstrategy, \t&rdtab,",
+	"\t&rdopen,   &nulldev,  &rdread,   &rdwrite,  &nodev,    &seltrue,",
 
 	"pc",
 	0,	70,	CHAR+INTR,
@@ -71,7 +90,7 @@ struct tab
 	".globl\t_pcrint\npcin:\tjsr\tr0,call; _pcrint\n",
 	".globl\t_pcpint\npcou:\tjsr\tr0,call; _pcpint\n",
 	"",
-	"\t&pcopen,   &pcclose,  &pcread,   &pcwrite,  &nodev,",
+	"\t&pcopen,   &pcclose,  &pcread,   &pcwrite,  &nodev,    &seltrue,",
 
 	"clock",
 	-2,	100,	INTR,
@@ -107,7 +126,7 @@ struct tab
 	"",
 	".globl\t_lpint\nlpou:\tjsr\tr0,call; _lpint\n",
 	"",
-	"\t&lpopen,   &lpclose,  &nodev,    &lpwrite,  &nodev,",
+	"\t&lpopen,   &lpclose,  &nodev,    &lpwrite,  &nodev,    &seltrue,",
 
 	"rf",
 	0,	204,	BLOCK+CHAR+INTR,
@@ -115,7 +134,7 @@ struct tab
 	".globl\t_rfintr\n",
 	"rfio:\tjsr\tr0,call; _rfintr\n",
 	"\t&nulldev,\t&nulldev,\t&rfstrategy, \t&rftab,",
-	"\t&nulldev,  &nulldev,  &rfread,   &rfwrite,  &nodev,",
+	"\t&nulldev,  &nulldev,  &rfread,   &rfwrite,  &nodev,    &seltrue,",
 
 	"hs",
 	0,	204,	BLOCK+CHAR+INTR,
@@ -123,7 +142,7 @@ struct tab
 	".globl\t_hsintr\n",
 	"hsio:\tjsr\tr0,call; _hsintr\n",
 	"\t&nulldev,\t&nulldev,\t&hsstrategy, \t&hstab,",
-	"\t&nulldev,  &nulldev,  &hsread,   &hswrite,  &nodev,",
+	"\t&nulldev,  &nulldev,  &hsread,   &hswrite,  &nodev,    &seltrue,",
 
 /*
  * 210 RC
@@ -143,7 +162,7 @@ struct tab
 	".globl\t_rkintr\n",
 	"rkio:\tjsr\tr0,call; _rkintr\n",
 	"\t&nulldev,\t&nulldev,\t&rkstrategy, \t&rktab,",
-	"\t&nulldev,  &nulldev,  &rkread,   &rkwrite,  &nodev,",
+	"\t&nulldev,  &nulldev,  &rkread,   &rkwrite,  &nodev,    &seltrue,",
 
 	"tm",
 	0,	224,	BLOCK+CHAR+INTR,
@@ -151,7 +170,7 @@ struct tab
 	".globl\t_tmintr\n",
 	"tmio:\tjsr\tr0,call; _tmintr\n",
 	"\t&tmopen,\t&tmclose,\t&tmstrategy, \t&tmtab,",
-	"\t&tmopen,   &tmclose,  &tmread,   &tmwrite,  &nodev,",
+	"\t&tmopen,   &tmclose,  &tmread,   &tmwrite,  &tmsgtty,  &seltrue,",
 
 	"ht",
 	0,	224,	BLOCK+CHAR+INTR,
@@ -159,7 +178,7 @@ struct tab
 	".globl\t_htintr\n",
 	"htio:\tjsr\tr0,call; _htintr\n",
 	"\t&htopen,\t&htclose,\t&htstrategy, \t&httab,",
-	"\t&htopen,   &htclose,  &htread,   &htwrite,  &nodev,",
+	"\t&htopen,   &htclose,  &htread,   &htwrite,  &htsgtty,  &seltrue,",
 
 	"cr",
 	0,	230,	CHAR+INTR,
@@ -167,7 +186,7 @@ struct tab
 	"",
 	".globl\t_crint\ncrin:\tjsr\tr0,call; _crint\n",
 	"",
-	"\t&cropen,   &crclose,  &crread,   &nodev,    &nodev,",
+	"\t&cropen,   &crclose,  &crread,   &nodev,    &nodev,    &seltrue,",
 
 /*
  * 234 UDC11
@@ -179,7 +198,7 @@ struct tab
 	".globl\t_rpintr\n",
 	"rpio:\tjsr\tr0,call; _rpintr\n",
 	"\t&nulldev,\t&nulldev,\t&rpstrategy, \t&rptab,",
-	"\t&nulldev,  &nulldev,  &rpread,   &rpwrite,  &nodev,",
+	"\t&nulldev,  &nulldev,  &rpread,   &rpwrite,  &nodev,    &seltrue,",
 
 	"hp",
 	0,	254,	BLOCK+CHAR+INTR,
@@ -187,7 +206,7 @@ struct tab
 	".globl\t_hpintr\n",
 	"hpio:\tjsr\tr0,call; _hpintr\n",
 	"\t&hpopen,\t&nulldev,\t&hpstrategy, \t&hptab,",
-	"\t&hpopen,   &nulldev,  &hpread,   &hpwrite,  &nodev,",
+	"\t&hpopen,   &nulldev,  &hpread,   &hpwrite,  &nodev,    &seltrue,",
 
 /*
  * 260 TA11
@@ -200,7 +219,7 @@ struct tab
 	".globl\t_dcrint\ndcin:\tjsr\tr0,call; _dcrint\n",
 	".globl\t_dcxint\ndcou:\tjsr\tr0,call; _dcxint\n",
 	"",
-	"\t&dcopen,   &dcclose,  &dcread,   &dcwrite,  &dcsgtty,",
+	"\t&dcopen,   &dcclose,  &dcread,   &dcwrite,  &dcsgtty,  &dcselect,",
 
 	"kl",
 	0,	308,	INTR+KL,
@@ -216,7 +235,7 @@ struct tab
 	".globl\t_dprint\ndpin:\tjsr\tr0,call; _dprint\n",
 	".globl\t_dpxint\ndpou:\tjsr\tr0,call; _dpxint\n",
 	"",
-	"\t&dpopen,   &dpclose,  &dpread,   &dpwrite,  &nodev,",
+	"\t&dpopen,   &dpclose,  &dpread,   &dpwrite,  &nodev,    &seltrue,",
 
 /*
  * DM11-A
@@ -228,7 +247,7 @@ struct tab
 	"",
 	".globl\t_dnint\ndnou:\tjsr\tr0,call; _dnint\n",
 	"",
-	"\t&dnopen,   &dnclose,  &nodev,    &dnwrite,  &nodev,",
+	"\t&dnopen,   &dnclose,  &nodev,    &dnwrite,  &nodev,    &seltrue,",
 
 	"dhdm",
 	0,	304,	INTR,
@@ -265,7 +284,7 @@ struct tab
 	".globl\t_dhrint\ndhin:\tjsr\tr0,call; _dhrint\n",
 	".globl\t_dhxint\ndhou:\tjsr\tr0,call; _dhxint\n",
 	"",
-	"\t&dhopen,   &dhclose,  &dhread,   &dhwrite,  &dhsgtty,",
+	"\t&dhopen,   &dhclose,  &dhread,   &dhwrite,  &dhsgtty,  &dhselect,",
 
 /*
  * GT40
@@ -361,9 +380,19 @@ char	*strg[]
 	"};",
 	"",
 	"int\trootdev\t{(%d<<8)|0};",
-	"int\tswapdev\t{(%d<<8)|0};",
 	"int\tswplo\t4000;\t/* cannot be zero */",
-	"int\tnswap\t872;",
+	"int\trdsize\t200;\t/* ram disk blocks */",
+	"",
+	"/*",
+	" * Swap devices: device, blocks from swplo.",
+	" * Swap is striped across them, so each",
+	" * should be on a drive of its own.",
+	" */",
+	"int\tswdevs[]",
+	"{",
+	"\t(%d<<8)|0,\t872,",
+	"\t0,\t0",
+	"};",
 	0,
 };
 
@@ -450,7 +479,7 @@ main()
 			printf("%s\t/* %s */\n", p->codee, q);
 			goto newc;
 		}
-		printf("\t&nodev,    &nodev,    &nodev,    &nodev,    &nodev,\t/* %s */\n", q);
+		printf("\t&nodev,    &nodev,    &nodev,    &nodev,    &nodev,    &nodev,\t/* %s */\n", q);
 	newc:;
 	}
 	puke(strg, root);
@@ -73,10 +73,11 @@
  * headers not pointing here that are used purely
  * as arguments to the I/O routines to describe
  * I/O to be done-- e.g. swbuf, just below, for
- * swapping.
+ * swapping, and corbuf, for core dumps.
  */
 char	buffers[NBUF][514];
-struct	buf	swbuf;
+struct	buf	swbuf[NSWDEV];
+struct	buf	corbuf;
 
 /*
  * Declarations of the tables for the magtape devices;
@@ -124,9 +125,13 @@ bread(dev, blkno)
 {
 	register struct buf *rbp;
 
+	sysstat.ss_bread++;
 	rbp = getblk(dev, blkno);
-	if (rbp->b_flags&B_DONE)
+	if (rbp->b_flags&B_DONE) {
+		sysstat.ss_bhit++;
 		return(rbp);
+	}
+	sysstat.ss_read++;
 	rbp->b_flags =| B_READ; // 设置B_READ标志位，将读取长度设定为-256(表示512字节），然后执行设定于bdevsw[]中的设备访问函数
 	rbp->b_wcount = -256;
 	(*bdevsw[dev.d_major].d_strategy)(rbp);
@@ -155,6 +160,8 @@ breada(adev, blkno, rablkno)
 	if (!incore(dev, blkno)) { // 执行incore()， 检查准备读取的设备的块的缓冲区是否存在
 		rbp = getblk(dev, blkno); // 如果缓冲区不存在，则执行getblk()获取缓冲区，如果尚未设置获取的缓冲区的B_DONE标志位，则启动从设备读取数据的处理
 		if ((rbp->b_flags&B_DONE) == 0) {
+			sysstat.ss_bread++;
+			sysstat.ss_read++;
 			rbp->b_flags =| B_READ;
 			rbp->b_wcount = -256;
 			(*bdevsw[adev.d_major].d_strategy)(rbp);
@@ -165,6 +172,7 @@ breada(adev, blkno, rablkno)
 		if (rabp->b_flags & B_DONE)
 			brelse(rabp);
 		else { // 如果未设置B_DONE标志位，则开始从设备读取数的处理，注意，此处并没有等待读取处理执行结束
+			sysstat.ss_read++;
 			rabp->b_flags =| B_READ|B_ASYNC;
 			rabp->b_wcount = -256;
 			(*bdevsw[adev.d_major].d_strategy)(rabp);
@@ -201,6 +209,7 @@ struct buf *bp;
 	flag = rbp->b_flags;
 	rbp->b_flags =& ~(B_READ | B_DONE | B_ERROR | B_DELWRI); // 清除下面的标志位, B_READ, B_DONE, B_ERROR, B_DELWRI
 	rbp->b_wcount = -256;
+	sysstat.ss_write++;
 	(*bdevsw[rbp->b_dev.d_major].d_strategy)(rbp); // 执行在bdevsw[]中注册的设备访问函数
 	if ((flag&B_ASYNC) == 0) { // 如果未设置B_ASYNC标志位，则等待设备处理结束后，调用brelse()释放缓冲区
 		iowait(rbp);
@@ -262,6 +271,10 @@ struct buf *bp;
 
 /*
  * release the buffer, with no I/O implied.
+ * A buffer taken for NODEV holds nothing
+ * worth keeping, so it goes to the head of
+ * the list, to be taken again before any
+ * block in the cache is pushed out.
  */
 
 /*
@@ -289,10 +302,17 @@ struct buf *bp;
 	sps = PS->integ; // 保存 PSW, 将处理器优先级提升到6防止发生中断
 	spl6();
 	rbp->b_flags =& ~(B_WANTED|B_BUSY|B_ASYNC); // 清除B_WANTED, B_BUSY, 和B_ASYNC标志位
-	(*backp)->av_forw = rbp; // 将缓冲区返回至av-list的末尾
-	rbp->av_back = *backp;
-	*backp = rbp;
-	rbp->av_forw = &bfreelist;
+	if (rbp->b_dev == NODEV) {
+		rbp->av_forw = bfreelist.av_forw;
+		rbp->av_back = &bfreelist;
+		bfreelist.av_forw->av_back = rbp;
+		bfreelist.av_forw = rbp;
+	} else {
+		(*backp)->av_forw = rbp; // 将缓冲区返回至av-list的末尾
+		rbp->av_back = *backp;
+		*backp = rbp;
+		rbp->av_forw = &bfreelist;
+	}
 	PS->integ = sps; // 将处理器优先级返回原值
 }
 
@@ -646,6 +666,9 @@ struct buf *bp;
 
 /*
  * swap I/O
+ * Each swap device has its own
+ * swbuf, so transfers to different
+ * devices overlap.
  */
 
 /*
@@ -662,29 +685,122 @@ struct buf *bp;
 
 swap(blkno, coreaddr, count, rdflg)
 {
+	register struct buf *bp;
+	register int *fp, c;
+	int b, d, d0, err;
+
+	err = 0;
+	b = blkno;
+	while (count > 0) {
+		/*
+		 * Start one transfer on each device
+		 * in ascending order, then wait for them.
+		 */
+		d0 = swdn(b);
+		do {
+			d = swdn(b);
+			c = count;
+			if (nswdev > 1 && c > (SWINT-lrem(b-swplo, SWINT))<<3)
+				c = (SWINT-lrem(b-swplo, SWINT))<<3;
+			bp = &swbuf[d];
+			fp = &bp->b_flags;
+			spl6();
+			while (*fp&B_BUSY) {
+				*fp =| B_WANTED;
+				sleep(fp, PSWP);
+			}
+			spl0();
+			*fp = B_BUSY | B_PHYS | rdflg;
+			bp->b_dev = swdevs[d].sw_dev;
+			bp->b_wcount = - (c<<5);	/* 32 w/block */
+			bp->b_blkno = swbno(b);
+			bp->b_addr = coreaddr<<6;	/* 64 b/block */
+			bp->b_xmem = (coreaddr>>10) & 077;
+			(*bdevsw[bp->b_dev.d_major].d_strategy)(bp);
+			b =+ c>>3;
+			coreaddr =+ c;
+			count =- c;
+		} while (count > 0 && d < nswdev-1);
+		for (bp = &swbuf[d0]; bp <= &swbuf[d]; bp++) {
+			fp = &bp->b_flags;
+			spl6();
+			while((*fp&B_DONE)==0)
+				sleep(fp, PSWP);
+			if (*fp&B_WANTED)
+				wakeup(fp);
+			spl0();
+			*fp =& ~(B_BUSY|B_WANTED);
+			err =| *fp&B_ERROR;
+		}
+	}
+	return(err);
+}
+
+/*
+ * Swap space is striped in SWINT
+ * block pieces across the nswdev devices
+ * in swdevs, each with nswap blocks
+ * from swplo.  swdn, swdev and swbno
+ * map a swap block to its place in
+ * swdevs, its device and its block there.
+ */
+swdn(bn)
+{
+
+	return(lrem(ldiv(bn-swplo, SWINT), nswdev));
+}
+
+swdev(bn)
+{
+
+	return(swdevs[swdn(bn)].sw_dev);
+}
+
+swbno(bn)
+{
+	register n;
+
+	if (nswdev <= 1)
+		return(bn);
+	n = ldiv(bn-swplo, SWINT);
+	return(swplo + ldiv(n, nswdev)*SWINT + lrem(bn-swplo, SWINT));
+}
+
+/*
+ * Write count clicks of core starting at coreaddr
+ * to consecutive blocks of dev starting at blkno,
+ * in a single transfer which bypasses the buffers.
+ * Used by core to dump a process image.
+ */
+cwrite(dev, blkno, coreaddr, count)
+{
+	register struct buf *bp;
 	register int *fp;
 
-	fp = &swbuf.b_flags;
+	bp = &corbuf;
+	fp = &bp->b_flags;
 	spl6();
-	while (*fp&B_BUSY) { // 如果有其他进程使用swbuf, 则设置swbuf.b_flags的B_WANTED标志位，然后进入睡眠状态
+	while (*fp&B_BUSY) {
 		*fp =| B_WANTED;
-		sleep(fp, PSWP);
+		sleep(fp, PRIBIO);
 	}
-	*fp = B_BUSY | B_PHYS | rdflg; // 如果可以使用swbuf, 则设置swbuf.b_flags的B_BUSY标志位、B_PHYS标志位（RAW输入输出）和rdflg标志位（读取或者写入）
-	swbuf.b_dev = swapdev; // 设置swbuf的参数启动交换磁盘的输入输出，将通过参数设定的以64字节为单位的地址和长度分别转换为字节单位和2的补数的字单位
-	swbuf.b_wcount = - (count<<5);	/* 32 w/block */
-	swbuf.b_blkno = blkno;
-	swbuf.b_addr = coreaddr<<6;	/* 64 b/block */
-	swbuf.b_xmem = (coreaddr>>10) & 077;
-	(*bdevsw[swapdev>>8].d_strategy)(&swbuf); // 调用交换磁盘的设备驱动
+	spl0();
+	*fp = B_BUSY | B_PHYS | B_WRITE;
+	bp->b_dev = dev;
+	bp->b_wcount = - (count<<5);	/* 32 w/click */
+	bp->b_blkno = blkno;
+	bp->b_addr = coreaddr<<6;
+	bp->b_xmem = (coreaddr>>10) & 077;
+	bp->b_error = 0;
+	(*bdevsw[dev.d_major].d_strategy)(bp);
 	spl6();
-	while((*fp&B_DONE)==0) // 进入睡眠状态等待交换磁盘的处理结束
-		sleep(fp, PSWP);
-	if (*fp&B_WANTED) // 交换磁盘处理结束后，唤醒正在等待swbuf的进程
+	while ((*fp&B_DONE) == 0)
+		sleep(fp, PRIBIO);
+	if (*fp&B_WANTED)
 		wakeup(fp);
 	spl0();
-	*fp =& ~(B_BUSY|B_WANTED); // 清除swbuf的B_BUSY标志位和B_WANTED标志位
-	return(*fp&B_ERROR); // 返回交换处理成功与否的标志，访问当对设备失败时候，设备驱动将设定swbuf.B_ERROR标志位
+	*fp =& ~(B_BUSY|B_WANTED);
+	geterror(bp);
 }
 
 /*
@@ -810,6 +926,141 @@ int (*strat)();
 	u.u_error = EFAULT;
 }
 
+/*
+ * Raw tape writes are queued instead of
+ * waited for, so that the tape can keep
+ * moving from one record to the next.
+ * The record is copied into core taken
+ * from coremap and described by one of
+ * the NTBUF headers at tb.
+ * *ablkno is the drive's record number;
+ * the new record follows those still queued.
+ * Errors are reported on a later call
+ * for the same device.
+ * Returns 0, having done nothing, if the
+ * record is odd or there is no core for it,
+ * or if it is the first on the tape,
+ * in which case the caller uses physio.
+ * So a tape without a write ring fails
+ * at once, on the record that failed.
+ */
+physq(strat, tb, dev, ablkno)
+int (*strat)();
+struct buf *tb;
+char **ablkno;
+{
+	register struct buf *bp, *qp;
+	register char *base;
+	int a, c, d, n, *sb;
+
+	if (u.u_count&01 || u.u_count==0 || *ablkno==0)
+		return(0);
+	c = ((u.u_count>>6) & 01777) + 1;
+	while ((bp = physqf(tb, dev)) == NULL || (a = malloc(coremap, c)) == 0)
+		if (physqw(tb, dev, 0) == 0)
+			return(0);
+	if (u.u_error) {
+		mfree(coremap, c, a);
+		return(1);
+	}
+	bp->b_flags = B_BUSY;
+	sb = getblk(NODEV);
+	base = u.u_base;
+	for (d = a; u.u_count; d =+ 8) {
+		n = 512;
+		if ((u.u_count&~0777) == 0)
+			n = u.u_count;
+		if (copyin(base, sb->b_addr, n)) {
+			u.u_error = EFAULT;
+			break;
+		}
+		pcopy((sb->b_addr>>6)&01777, sb->b_addr&077, d, 0, n>>1);
+		base =+ n;
+		u.u_count =- n;
+	}
+	brelse(sb);
+	n = base - u.u_base;
+	if (u.u_error) {
+		mfree(coremap, c, a);
+		bp->b_flags = 0;
+		return(1);
+	}
+	bp->b_flags = B_BUSY | B_PHYS | B_WRITE;
+	bp->b_dev = dev;
+	bp->b_addr = a<<6;
+	bp->b_xmem = (a>>10) & 077;
+	bp->b_wcount = -((n>>1) & 077777);
+	bp->b_error = 0;
+	spl6();
+	n = 0;
+	for (qp = tb; qp < &tb[NTBUF]; qp++)
+		if (qp != bp && qp->b_dev == dev &&
+		    (qp->b_flags&(B_BUSY|B_DONE)) == B_BUSY)
+			n++;
+	bp->b_blkno = *ablkno + n;
+	(*strat)(bp);
+	spl0();
+	return(1);
+}
+
+/*
+ * Release the headers at tb whose writes
+ * have finished, and the core they used.
+ * A failed write is kept until its own
+ * device dev asks, and reported to it.
+ * Returns a free header, or NULL.
+ */
+physqf(tb, dev)
+struct buf *tb;
+{
+	register struct buf *bp, *fp;
+
+	fp = NULL;
+	for (bp = tb; bp < &tb[NTBUF]; bp++) {
+		if ((bp->b_flags&(B_BUSY|B_DONE)) == B_BUSY)
+			continue;
+		if (bp->b_flags&B_BUSY) {
+			if (bp->b_flags&B_ERROR && bp->b_dev != dev)
+				continue;
+			mfree(coremap, (((-bp->b_wcount)>>5) & 01777) + 1,
+			    ((bp->b_xmem&077)<<10) | ((bp->b_addr>>6)&01777));
+			if (bp->b_flags&B_ERROR)
+				u.u_error = EIO;
+			bp->b_flags = 0;
+		}
+		fp = bp;
+	}
+	return(fp);
+}
+
+/*
+ * Wait for the queued writes at tb to finish:
+ * all of those for dev, or, if all is 0,
+ * any one to free a header.
+ * Returns 0 if none was queued.
+ */
+physqw(tb, dev, all)
+struct buf *tb;
+{
+	register struct buf *bp;
+	register int n;
+
+	n = 0;
+	spl6();
+	for (bp = tb; bp < &tb[NTBUF]; bp++)
+		if ((bp->b_flags&(B_BUSY|B_DONE)) == B_BUSY &&
+		    (all == 0 || bp->b_dev == dev)) {
+			n++;
+			while ((bp->b_flags&B_DONE) == 0)
+				sleep(bp, PRIBIO);
+			if (all == 0)
+				break;
+		}
+	spl0();
+	physqf(tb, dev);
+	return(n);
+}
+
 /*
  * Pick up the device's error number and pass it to the user;
  * if there is an error but the number is 0 set a generalized
@@ -161,6 +161,14 @@ dcwrite(dev)
 	ttwrite(&dc11[dev.d_minor]);
 }
 
+/*
+ * Select on a DC11
+ */
+dcselect(dev, rw)
+{
+	return(ttselect(&dc11[dev.d_minor], rw));
+}
+
 /*
  * DC11 transmitter interrupt.
  */
@@ -169,8 +177,10 @@ dcxint(dev)
 	register struct tty *tp;
 
 	ttstart(tp = &dc11[dev.d_minor]);
-	if (tp->t_outq.c_cc == 0 || tp->t_outq.c_cc == TTLOWAT)
+	if (tp->t_outq.c_cc == 0 || tp->t_outq.c_cc == TTLOWAT) {
 		wakeup(&tp->t_outq);
+		selwakeup();
+	}
 }
 
 /*
@@ -125,6 +125,14 @@ dhwrite(dev)
 	ttwrite(&dh11[dev.d_minor]);
 }
 
+/*
+ * select on a DH11 line
+ */
+dhselect(dev, rw)
+{
+	return(ttselect(&dh11[dev.d_minor], rw));
+}
+
 /*
  * DH11 receiver interrupt.
  */
@@ -278,6 +286,8 @@ struct tty *atp;
 		tp->t_state =& ~ASLEEP;
 		wakeup(&tp->t_outq);
 	}
+	if (tp->t_outq.c_cc<=TTLOWAT)
+		selwakeup();
 	/*
 	 * If any characters were set up, start transmission;
 	 * otherwise, check for possible delay.
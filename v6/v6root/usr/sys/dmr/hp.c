@@ -65,13 +65,49 @@ struct	buf	hpbuf;
 
 char	hp_openf;
 
+/*
+ * Each drive has its own queue, sorted by cylinder.
+ * Whenever the controller is free, seeks are started
+ * on all the drives with work to do, and a transfer
+ * is done on some drive that has reached its cylinder;
+ * see rp.c.
+ * hptab.d_actf is the buffer being transferred.
+ */
+struct	hpdrive
+{
+	char	hp_state;	/* see below */
+	char	hp_errcnt;	/* error count */
+	int	hp_cyl;		/* cylinder sought +1, 0 if not known */
+	struct	buf *hp_actf;	/* head of drive queue */
+} hpdrive[NHP];
+
+#define	DIDLE	0		/* not seeking or transferring */
+#define	DSEEK	1		/* seek in progress */
+#define	DONCYL	2		/* on cylinder, waiting for controller */
+#define	DXFER	3		/* transfer in progress */
+
+int	hpnext;			/* drive last given a transfer */
+
+/*
+ * Statistics for each drive, read by iostat.
+ */
+struct
+{
+	int	ds_seek;	/* seeks */
+	int	ds_xfer;	/* transfers */
+	int	ds_blk;		/* blocks transferred */
+} hpstat[NHP];
+
 			/* Drive Commands */
 #define	GO	01
+#define	SEEK	04
 #define	PRESET	020
 #define	RECAL	06
 #define RCLR	010
 #define OFFSET	014
 
+#define	IENABLE	0100	/* hpcs1 - interrupt enable */
+#define	RDY	0200	/* hpcs1 - controller ready */
 #define	READY	0200	/* hpds - drive ready */
 #define	PIP	020000	/* hpds - Positioning Operation in Progress */
 #define	ERR	040000	/* hpcs1 - composite error */
@@ -111,6 +147,7 @@ struct buf *abp;
 {
 	register struct buf *bp;
 	register char *p1, *p2;
+	struct hpdrive *dp;
 
 	bp = abp;
 	p1 = &hp_sizes[bp->b_dev.d_minor&07];
@@ -127,9 +164,10 @@ struct buf *abp;
 	p1 = ldiv(p1, 22);
 	bp->trksec = (p1%19)<<8 | p2;
 	bp->cylin =+ p1/19;
+	dp = &hpdrive[bp->b_dev.d_minor>>3];
 	spl5();
-	if ((p1 = hptab.d_actf)==0)
-		hptab.d_actf = bp;
+	if ((p1 = dp->hp_actf)==0)
+		dp->hp_actf = bp;
 	else {
 		for (; p2 = p1->av_forw; p1 = p2) {
 			if (p1->cylin <= bp->cylin
@@ -149,24 +187,77 @@ struct buf *abp;
 hpstart()
 {
 	register struct buf *bp;
+	register struct hpdrive *dp;
+	register int n;
 
-	if ((bp = hptab.d_actf) == 0)
+	if (hptab.d_active)
 		return;
-	hptab.d_active++;
-	HPADDR->hpcs2 = bp->b_dev.d_minor >> 3;
-	HPADDR->hpca = bp->cylin;
-	rhstart(bp, &HPADDR->hpda, bp->trksec, &HPADDR->hpbae);
+	/*
+	 * Start seeks on idle drives with work.
+	 */
+	for (n=0; n<NHP; n++) {
+		dp = &hpdrive[n];
+		if (dp->hp_state != DIDLE || (bp = dp->hp_actf) == 0)
+			continue;
+		if (dp->hp_cyl == bp->cylin+1) {
+			dp->hp_state = DONCYL;
+			continue;
+		}
+		dp->hp_cyl = bp->cylin+1;
+		dp->hp_state = DSEEK;
+		hpstat[n].ds_seek++;
+		HPADDR->hpcs2 = n;
+		HPADDR->hpca = bp->cylin;
+		HPADDR->hpcs1 = IENABLE|SEEK|GO;
+	}
+	/*
+	 * Start a transfer on a drive
+	 * at its cylinder, taking the
+	 * drives in turn.
+	 */
+	for (n=0; n<NHP; n++) {
+		if (++hpnext >= NHP)
+			hpnext = 0;
+		dp = &hpdrive[hpnext];
+		if (dp->hp_state == DONCYL) {
+			dp->hp_state = DXFER;
+			bp = dp->hp_actf;
+			hptab.d_actf = bp;
+			hptab.d_active++;
+			HPADDR->hpcs2 = hpnext;
+			HPADDR->hpca = bp->cylin;
+			rhstart(bp, &HPADDR->hpda, bp->trksec, &HPADDR->hpbae);
+			return;
+		}
+	}
 }
 
 hpintr()
 {
 	register struct buf *bp;
+	register struct hpdrive *dp;
 	register int ctr;
 
-	if (hptab.d_active == 0)
+	/*
+	 * Drives which have finished
+	 * seeking raise attention.
+	 */
+	if (ctr = HPADDR->hpas&0377) {
+		HPADDR->hpas = ctr;
+		for (dp = hpdrive; ctr; dp++) {
+			if ((ctr&01) && dp->hp_state == DSEEK)
+				dp->hp_state = DONCYL;
+			ctr =>> 1;
+		}
+	}
+	if (hptab.d_active == 0 || (HPADDR->hpcs1&RDY) == 0) {
+		hpstart();
 		return;
+	}
 	bp = hptab.d_actf;
+	dp = &hpdrive[bp->b_dev.d_minor>>3];
 	hptab.d_active = 0;
+	dp->hp_state = DIDLE;
 	if (HPADDR->hpcs1 & ERR) {		/* error bit */
 		deverror(bp, HPADDR->hpcs2, 0);
 		if(HPADDR->hper1 & (DU|DTE|OPI)) {
@@ -176,14 +267,26 @@ hpintr()
 			while ((HPADDR->hpds&PIP) && --ctr);
 		}
 		HPADDR->hpcs1 = RCLR|GO;
-		if (++hptab.d_errcnt <= 10) {
+		/*
+		 * Seek again on this drive,
+		 * and on any whose attention
+		 * the clear may have lost.
+		 */
+		for (ctr=0; ctr<NHP; ctr++)
+			if (hpdrive[ctr].hp_state == DSEEK)
+				hpdrive[ctr].hp_state = DIDLE;
+		dp->hp_cyl = 0;
+		if (++dp->hp_errcnt <= 10) {
 			hpstart();
 			return;
 		}
 		bp->b_flags =| B_ERROR;
 	}
-	hptab.d_errcnt = 0;
-	hptab.d_actf = bp->av_forw;
+	dp->hp_errcnt = 0;
+	dp->hp_actf = bp->av_forw;
+	ctr = bp->b_dev.d_minor>>3;
+	hpstat[ctr].ds_xfer++;
+	hpstat[ctr].ds_blk =+ ldiv(255-bp->b_wcount, 256);
 	bp->b_resid = HPADDR->hpwc;
 	iodone(bp);
 	hpstart();
@@ -31,6 +31,7 @@ struct {
 
 struct	devtab	httab;
 struct	buf	rhtbuf;
+struct	buf	qhtbuf[NTBUF];	/* queued raw writes, see physq */
 
 #define	NUNIT	8
 
@@ -60,6 +61,7 @@ char	*h_nxrec[NUNIT];
 
 #define	SSEEK	1
 #define	SIO	2
+#define	SCOM	3
 
 htopen(dev, flag)
 {
@@ -72,7 +74,7 @@ htopen(dev, flag)
 		h_openf[unit]++;
 		h_blkno[unit] = 0;
 		h_nxrec[unit] = 65535;
-		hcommand(dev, NOP);
+		hcommand(dev, NOP, 0);
 	}
 }
 
@@ -81,22 +83,35 @@ htclose(dev, flag)
 	register int unit;
 
 	unit = dev.d_minor&077;
+	physqw(qhtbuf, dev, 1);
 	h_openf[unit] = 0;
 	if (flag) {
-		hcommand(dev, WEOF);
-		hcommand(dev, WEOF);
+		hcommand(dev, WEOF, 0);
+		hcommand(dev, WEOF, 0);
 	}
-	hcommand(dev, REW);
+	hcommand(dev, REW, 0);
 }
 
-hcommand(dev, com)
+/*
+ * Do com, which moves the tape without
+ * a transfer, n records for a space.
+ * The controller is marked busy until the
+ * drive is done, or for a rewind has
+ * started, so htstart leaves it alone,
+ * and what queued meanwhile is started.
+ * Returns nonzero on an error.
+ */
+hcommand(dev, com, n)
 {
-	register unit;
+	register unit, cs;
 	extern lbolt;
 
 	unit = dev.d_minor;
+	spl5();
 	while (httab.d_active || (HTADDR->htcs1 & CRDY)==0)
 		sleep(&lbolt, 1);
+	httab.d_active = SCOM;
+	spl0();
 	HTADDR->htcs2 = (unit>>3)&07;
 	while((HTADDR->htds&DRY) == 0)
 		sleep(&lbolt, 1);
@@ -105,7 +120,35 @@ hcommand(dev, com)
 		HTADDR->httc = P1600 | (unit&07);
 	while((HTADDR->htds&(MOL|PIP)) != MOL)
 		sleep(&lbolt, 1);
+	HTADDR->htfc = -n;
 	HTADDR->htcs1 = com | GO;
+	if (com != REW)
+		while ((HTADDR->htds&(DRY|PIP)) != DRY)
+			sleep(&lbolt, 1);
+	cs = HTADDR->htcs1;
+	if (cs & ERR)
+		HTADDR->htcs1 = ERR|CLR|GO;
+	spl5();
+	httab.d_active = 0;
+	htstart();
+	spl0();
+	return(cs & ERR);
+}
+
+/*
+ * stty on the raw tape spaces forward
+ * over u.u_arg[0] records.
+ */
+htsgtty(dev, v)
+{
+
+	if (v) {
+		u.u_error = ENOTTY;
+		return;
+	}
+	physqw(qhtbuf, dev, 1);
+	if (hcommand(dev, SFORW, u.u_arg[0]))
+		u.u_error = EIO;
 }
 
 htstrategy(abp)
@@ -196,7 +239,7 @@ htintr()
 		deverror(bp, HTADDR->hter, 0);
  */
 		if(HTADDR->htds&EOF) {
-			if(bp != &rhtbuf && h_openf[unit])
+			if((bp->b_flags&B_PHYS)==0 && h_openf[unit])
 				h_openf[unit] = -1;
 		}
 		HTADDR->htcs1 = ERR|CLR|GO;
@@ -225,6 +268,7 @@ htintr()
 
 htread(dev)
 {
+	physqw(qhtbuf, dev, 1);
 	htphys(dev);
 	physio(htstrategy, &rhtbuf, dev, B_READ);
 	u.u_count = -rhtbuf.b_resid;
@@ -232,6 +276,11 @@ htread(dev)
 
 htwrite(dev)
 {
+	if (physq(htstrategy, qhtbuf, dev, &h_blkno[dev.d_minor&077])) {
+		u.u_count = 0;
+		return;
+	}
+	physqw(qhtbuf, dev, 1);
 	htphys(dev);
 	physio(htstrategy, &rhtbuf, dev, B_WRITE);
 	u.u_count = 0;
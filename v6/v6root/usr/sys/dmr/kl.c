@@ -89,8 +89,10 @@ klxint(dev)
 
 	tp = &kl11[dev.d_minor];
 	ttstart(tp);
-	if (tp->t_outq.c_cc == 0 || tp->t_outq.c_cc == TTLOWAT)
+	if (tp->t_outq.c_cc == 0 || tp->t_outq.c_cc == TTLOWAT) {
 		wakeup(&tp->t_outq);
+		selwakeup();
+	}
 }
 
 klrint(dev)
@@ -107,6 +109,11 @@ klrint(dev)
 	ttyinput(c, tp);
 }
 
+klselect(dev, rw)
+{
+	return(ttselect(&kl11[dev.d_minor], rw));
+}
+
 klsgtty(dev, v)
 int *v;
 {
@@ -0,0 +1,95 @@
+#
+/*
+ */
+
+/*
+ *	Kernel execution profile.
+ *	While enabled, every clock tick taken
+ *	in kernel mode charges the interrupted pc
+ *	to a histogram bucket.
+ *	Reading the device returns the histogram
+ *	in the format of mon.out (see prof (I)):
+ *	low pc, high pc, a zero call count, buckets.
+ *	Writing two words (low pc, high pc) clears
+ *	the histogram and starts sampling that
+ *	range; writing two equal words stops it.
+ */
+
+#include "../param.h"
+#include "../systm.h"
+#include "../user.h"
+
+#define	KPSIZ	512		/* buckets in histogram */
+
+struct
+{
+	char	*kp_low;	/* pc of first bucket */
+	char	*kp_high;	/* pc beyond last bucket */
+	int	kp_ncnt;	/* number of call counts, always 0 */
+	int	kp_buf[KPSIZ];
+} kprof;
+
+int	kpshift;		/* log2 of words per bucket */
+int	kpnbuck;		/* buckets in use */
+
+kpread(dev)
+{
+	register char *p;
+	register n, i;
+
+	p = &kprof;
+	n = 6 + kpnbuck*2;
+	i = u.u_offset[1];
+	while(u.u_offset[0] == 0 && u.u_offset[1] < n)
+		if(passc(p[i++]) < 0)
+			return;
+}
+
+kpwrite(dev)
+{
+	register char *p;
+	register n, c;
+	int w[2];
+
+	if(!suser())
+		return;
+	p = w;
+	for(n=0; n<4; n++) {
+		if((c = cpass()) < 0) {
+			if(u.u_error == 0)
+				u.u_error = EINVAL;
+			return;
+		}
+		*p++ = c;
+	}
+	kpflag = 0;
+	if(w[0] == w[1])
+		return;
+	n = ((w[1]-w[0])>>1) & 077777;
+	kpshift = 0;
+	while((KPSIZ<<kpshift) < n)
+		kpshift++;
+	kpnbuck = ((n-1)>>kpshift) + 1;
+	kprof.kp_low = w[0];
+	kprof.kp_high = w[0] + (kpnbuck<<(kpshift+1));
+	for(n=0; n<KPSIZ; n++)
+		kprof.kp_buf[n] = 0;
+	kpflag++;
+}
+
+/*
+ * Called from clock with the pc
+ * of a tick taken in kernel mode.
+ */
+kpclock(pc)
+char *pc;
+{
+	register char *p;
+	register n;
+
+	p = pc - kprof.kp_low;
+	if(p >= kprof.kp_high - kprof.kp_low)
+		return;
+	n = p;
+	kprof.kp_buf[((n>>1)&077777) >> kpshift]++;
+}
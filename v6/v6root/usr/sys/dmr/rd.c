@@ -0,0 +1,77 @@
+#
+/*
+ */
+
+/*
+ * RAM disk driver.
+ * The disk is rdsize blocks of core
+ * taken from coremap the first time
+ * it is opened and never given back;
+ * rdsize is set in c.c.
+ * Transfers are core to core copies
+ * and complete at once.
+ */
+
+#include "../param.h"
+#include "../buf.h"
+#include "../conf.h"
+#include "../user.h"
+#include "../systm.h"
+
+struct	devtab	rdtab;
+struct	buf	rrdbuf;
+int	rdaddr;			/* core address of disk (*64) */
+
+rdopen(dev, flag)
+{
+
+	if(dev.d_minor != 0 || rdsize <= 0 || rdsize > 4000) {
+		u.u_error = ENXIO;
+		return;
+	}
+	if(rdaddr == 0 && (rdaddr = malloc(coremap, rdsize*8)) == 0)
+		u.u_error = ENXIO;
+}
+
+rdstrategy(abp)
+struct buf *abp;
+{
+	register struct buf *bp;
+	register a, b;
+	int n, w;
+
+	bp = abp;
+	n = -bp->b_wcount;
+	b = bp->b_blkno;
+	if(rdaddr == 0 || b < 0 || b+((n+255)>>8) > rdsize) {
+		bp->b_flags =| B_ERROR;
+		iodone(bp);
+		return;
+	}
+	a = rdaddr + (b<<3);
+	b = (bp->b_xmem<<10) | ((bp->b_addr>>6) & 01777);
+	while(n > 0) {
+		w = n;
+		if(w > 256)
+			w = 256;
+		if(bp->b_flags&B_READ)
+			pcopy(a, 0, b, bp->b_addr&077, w); else
+			pcopy(b, bp->b_addr&077, a, 0, w);
+		a =+ 8;
+		b =+ 8;
+		n =- w;
+	}
+	iodone(bp);
+}
+
+rdread(dev)
+{
+
+	physio(rdstrategy, &rrdbuf, dev, B_READ);
+}
+
+rdwrite(dev)
+{
+
+	physio(rdstrategy, &rrdbuf, dev, B_WRITE);
+}
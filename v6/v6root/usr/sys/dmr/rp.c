@@ -41,8 +41,43 @@ struct {
 struct	devtab	rptab;
 struct	buf	rrpbuf;
 
+/*
+ * Each drive has its own queue, sorted by cylinder.
+ * Whenever the controller is free, seeks are started
+ * on all the drives with work to do, and a transfer
+ * is done on some drive that has reached its cylinder.
+ * Thus seeks on several drives overlap one another
+ * and the transfers.
+ * rptab.d_actf is the buffer being transferred.
+ */
+struct	rpdrive
+{
+	char	rp_state;	/* see below */
+	char	rp_errcnt;	/* error count */
+	int	rp_cyl;		/* cylinder sought +1, 0 if not known */
+	struct	buf *rp_actf;	/* head of drive queue */
+} rpdrive[NRP];
+
+#define	DIDLE	0		/* not seeking or transferring */
+#define	DSEEK	1		/* seek in progress */
+#define	DONCYL	2		/* on cylinder, waiting for controller */
+#define	DXFER	3		/* transfer in progress */
+
+int	rpnext;			/* drive last given a transfer */
+
+/*
+ * Statistics for each drive, read by iostat.
+ */
+struct
+{
+	int	ds_seek;	/* seeks */
+	int	ds_xfer;	/* transfers */
+	int	ds_blk;		/* blocks transferred */
+} rpstat[NRP];
+
 #define	GO	01
 #define	RESET	0
+#define	SEEK	010
 #define	HSEEK	014
 
 #define	IENABLE	0100
@@ -66,6 +101,7 @@ struct buf *abp;
 {
 	register struct buf *bp;
 	register char *p1, *p2;
+	struct rpdrive *dp;
 
 	bp = abp;
 	if(bp->b_flags&B_PHYS)
@@ -84,9 +120,10 @@ struct buf *abp;
 	p1 = ldiv(p1, 10);
 	bp->trksec = (p1%20)<<8 | p2;
 	bp->cylin =+ p1/20;
+	dp = &rpdrive[bp->b_dev.d_minor>>3];
 	spl5();
-	if ((p1 = rptab.d_actf)==0)
-		rptab.d_actf = bp;
+	if ((p1 = dp->rp_actf)==0)
+		dp->rp_actf = bp;
 	else {
 		for (; p2 = p1->av_forw; p1 = p2) {
 			if (p1->cylin <= bp->cylin
@@ -106,23 +143,76 @@ struct buf *abp;
 rpstart()
 {
 	register struct buf *bp;
+	register struct rpdrive *dp;
+	register int n;
 
-	if ((bp = rptab.d_actf) == 0)
+	if (rptab.d_active)
 		return;
-	rptab.d_active++;
-	RPADDR->rpda = bp->trksec;
-	devstart(bp, &RPADDR->rpca, bp->cylin, bp->b_dev.d_minor>>3);
+	/*
+	 * Start seeks on idle drives with work.
+	 */
+	for (n=0; n<NRP; n++) {
+		dp = &rpdrive[n];
+		if (dp->rp_state != DIDLE || (bp = dp->rp_actf) == 0)
+			continue;
+		if (dp->rp_cyl == bp->cylin+1) {
+			dp->rp_state = DONCYL;
+			continue;
+		}
+		dp->rp_cyl = bp->cylin+1;
+		dp->rp_state = DSEEK;
+		rpstat[n].ds_seek++;
+		RPADDR->rpca = bp->cylin;
+		RPADDR->rpcs = (n<<8) | IENABLE | SEEK | GO;
+		while ((RPADDR->rpcs&READY) == 0);
+	}
+	/*
+	 * Start a transfer on a drive
+	 * at its cylinder, taking the
+	 * drives in turn.
+	 */
+	for (n=0; n<NRP; n++) {
+		if (++rpnext >= NRP)
+			rpnext = 0;
+		dp = &rpdrive[rpnext];
+		if (dp->rp_state == DONCYL) {
+			dp->rp_state = DXFER;
+			bp = dp->rp_actf;
+			rptab.d_actf = bp;
+			rptab.d_active++;
+			RPADDR->rpda = bp->trksec;
+			devstart(bp, &RPADDR->rpca, bp->cylin, rpnext);
+			return;
+		}
+	}
 }
 
 rpintr()
 {
 	register struct buf *bp;
+	register struct rpdrive *dp;
 	register int ctr;
 
-	if (rptab.d_active == 0)
+	/*
+	 * Drives which have finished
+	 * seeking raise attention.
+	 */
+	if (ctr = RPADDR->rpds&0377) {
+		RPADDR->rpds = ctr;
+		for (dp = rpdrive; ctr; dp++) {
+			if ((ctr&01) && dp->rp_state == DSEEK)
+				dp->rp_state = DONCYL;
+			ctr =>> 1;
+		}
+	}
+	if (rptab.d_active == 0 || (RPADDR->rpcs&READY) == 0) {
+		rpstart();
 		return;
+	}
 	bp = rptab.d_actf;
+	dp = &rpdrive[bp->b_dev.d_minor>>3];
 	rptab.d_active = 0;
+	dp->rp_state = DIDLE;
 	if (RPADDR->rpcs < 0) {		/* error bit */
 		deverror(bp, RPADDR->rper, RPADDR->rpds);
 		if(RPADDR->rpds & (SUFU|SUSI|HNF)) {
@@ -133,14 +223,26 @@ rpintr()
 		RPADDR->rpcs = RESET|GO;
 		ctr = 0;
 		while ((RPADDR->rpcs&READY) == 0 && --ctr);
-		if (++rptab.d_errcnt <= 10) {
+		/*
+		 * Seek again on this drive,
+		 * and on any whose attention
+		 * the reset may have lost.
+		 */
+		for (ctr=0; ctr<NRP; ctr++)
+			if (rpdrive[ctr].rp_state == DSEEK)
+				rpdrive[ctr].rp_state = DIDLE;
+		dp->rp_cyl = 0;
+		if (++dp->rp_errcnt <= 10) {
 			rpstart();
 			return;
 		}
 		bp->b_flags =| B_ERROR;
 	}
-	rptab.d_errcnt = 0;
-	rptab.d_actf = bp->av_forw;
+	dp->rp_errcnt = 0;
+	dp->rp_actf = bp->av_forw;
+	ctr = bp->b_dev.d_minor>>3;
+	rpstat[ctr].ds_xfer++;
+	rpstat[ctr].ds_blk =+ ldiv(255-bp->b_wcount, 256);
 	bp->b_resid = RPADDR->rpwc;
 	iodone(bp);
 	rpstart();
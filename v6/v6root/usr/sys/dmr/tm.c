@@ -22,6 +22,7 @@ struct {
 
 struct	devtab	tmtab;
 struct	buf	rtmbuf;
+struct	buf	qtmbuf[NTBUF];	/* queued raw writes, see physq */
 
 char	t_openf[8];
 char	*t_blkno[8];
@@ -47,6 +48,7 @@ char	*t_nxrec[8];
 
 #define	SSEEK	1
 #define	SIO	2
+#define	SCOM	3
 
 tmopen(dev, flag)
 {
@@ -67,19 +69,57 @@ tmclose(dev, flag)
 	register int dminor;
 
 	dminor = dev.d_minor;
+	physqw(qtmbuf, dev, 1);
 	t_openf[dminor] = 0;
 	if (flag)
-		tcommand(dminor, WEOF);
-	tcommand(dminor, REW);
+		tcommand(dminor, WEOF, 0);
+	tcommand(dminor, REW, 0);
 }
 
-tcommand(unit, com)
+/*
+ * Do com, which moves the tape without
+ * a transfer, n records for a space.
+ * The controller is marked busy until it
+ * is done, so tmstart leaves it alone,
+ * and what queued meanwhile is started.
+ * Returns nonzero on an error.
+ */
+tcommand(unit, com, n)
 {
+	register int cs;
 	extern lbolt;
 
+	spl5();
 	while (tmtab.d_active || (TMADDR->tmcs & CRDY)==0)
 		sleep(&lbolt, 1);
+	tmtab.d_active = SCOM;
+	spl0();
+	TMADDR->tmbc = -n;
 	TMADDR->tmcs = DENS|com|GO | (unit<<8);
+	while ((TMADDR->tmcs & CRDY)==0)
+		sleep(&lbolt, 1);
+	cs = TMADDR->tmcs;
+	spl5();
+	tmtab.d_active = 0;
+	tmstart();
+	spl0();
+	return(cs < 0);
+}
+
+/*
+ * stty on the raw tape spaces forward
+ * over u.u_arg[0] records.
+ */
+tmsgtty(dev, v)
+{
+
+	if (v) {
+		u.u_error = ENOTTY;
+		return;
+	}
+	physqw(qtmbuf, dev, 1);
+	if (tcommand(dev.d_minor, SFORW, u.u_arg[0]))
+		u.u_error = EIO;
 }
 
 tmstrategy(abp)
@@ -179,7 +219,7 @@ tmintr()
 				return;
 			}
 		} else
-			if(bp != &rtmbuf && (TMADDR->tmer&EOF)==0)
+			if((bp->b_flags&B_PHYS)==0 && (TMADDR->tmer&EOF)==0)
 				t_openf[unit] = -1;
 		bp->b_flags =| B_ERROR;
 		tmtab.d_active = SIO;
@@ -198,6 +238,7 @@ tmintr()
 
 tmread(dev)
 {
+	physqw(qtmbuf, dev, 1);
 	tmphys(dev);
 	physio(tmstrategy, &rtmbuf, dev, B_READ);
 	u.u_count = -rtmbuf.b_resid;
@@ -205,6 +246,11 @@ tmread(dev)
 
 tmwrite(dev)
 {
+	if (physq(tmstrategy, qtmbuf, dev, &t_blkno[dev.d_minor])) {
+		u.u_count = 0;
+		return;
+	}
+	physqw(qtmbuf, dev, 1);
 	tmphys(dev);
 	physio(tmstrategy, &rtmbuf, dev, B_WRITE);
 	u.u_count = 0;
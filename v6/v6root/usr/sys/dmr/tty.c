@@ -179,6 +179,7 @@ struct tty *atp;
 	while (getc(&tp->t_outq) >= 0);
 	wakeup(&tp->t_rawq);
 	wakeup(&tp->t_outq);
+	selwakeup();
 	sps = PS->integ;
 	spl5();
 	while (getc(&tp->t_rawq) >= 0);
@@ -279,6 +280,7 @@ struct tty *atp;
 		wakeup(&tp->t_rawq);
 		if (putc(0377, &tp->t_rawq)==0)
 			tp->t_delct++;
+		selwakeup();
 	}
 	if (t_flags&ECHO) {
 		ttyoutput(c, tp);
@@ -481,6 +483,26 @@ struct tty *atp;
 		while (tp->t_canq.c_cc && passc(getc(&tp->t_canq))>=0);
 }
 
+/*
+ * Called from the device's select routine after it has
+ * calculated the tty-structure given as argument.
+ * Return true if a read (rw==FREAD) or write
+ * would not block.  A line without carrier
+ * is ready since the read or write returns at once.
+ */
+ttselect(atp, rw)
+struct tty *atp;
+{
+	register struct tty *tp;
+
+	tp = atp;
+	if ((tp->t_state&CARR_ON)==0)
+		return(1);
+	if (rw == FREAD)
+		return(tp->t_canq.c_cc || tp->t_delct);
+	return(tp->t_outq.c_cc <= TTLOWAT);
+}
+
 /*
  * Called from the device's write routine after it has
  * calculated the tty-structure given as argument.
@@ -42,6 +42,7 @@ struct	inode // 内存中的inode通过inode结构体的数组inode[]管理
 #define	IMOUNT	010		/* inode is mounted on */ // 该inode[]元素为挂载点
 #define	IWANT	020		/* some process waiting on lock */ // 存在等待解锁的inode[]元素的进程
 #define	ITEXT	040		/* inode is pure text prototype */ // 该inode[]元素作为代码段分配给进程
+#define	IMAP	0100		/* inode is mapped by some process */
 
 /* modes */
 #define	IALLOC	0100000		/* file is used */
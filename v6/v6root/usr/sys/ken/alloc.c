@@ -78,11 +78,28 @@ iinit()
  */
 
 alloc(dev)
+{
+	register bno, *bp;
+
+	if((bno = balloc(dev)) == 0)
+		return(NULL);
+	bp = getblk(dev, bno); // 利用取得的块编号，执行getblk()，取得对应的缓冲区
+	clrbuf(bp); // 将取得的缓冲区清0
+	return(bp);
+}
+
+/*
+ * balloc is alloc without the buffer:
+ * it returns the number of the block
+ * taken from the free list, or 0.
+ */
+balloc(dev)
 {
 	int bno;
 	register *bp, *ip, *fp;
 
 	fp = getfs(dev); // 取得与参数指定的设备编号相对应的filsys结构体
+loop:
 	while(fp->s_flock) // 如果filsys结构体被加锁，则进入睡眠状态直至解锁
 		sleep(&fp->s_flock, PINOD);
 	do { // 进行循环直至取得合适的块编号，如果取得的块编号 未指向存储区域，badblock()将返回1
@@ -102,16 +119,16 @@ alloc(dev)
 		fp->s_flock = 0; // 将filsys结构体解锁
 		wakeup(&fp->s_flock); // 唤醒正在等待解锁filsys结构体的进程
 	}
-	bp = getblk(dev, bno); // 利用取得的块编号，执行getblk()，取得对应的缓冲区
-	clrbuf(bp); // 将取得的缓冲区清0
 	fp->s_fmod = 1; // 设置filsys结构体的更新标志位
-	return(bp);
+	return(bno);
 
 nospace:
 	fp->s_nfree = 0;
+	if(itrwait(dev))	/* itrd has blocks to give back */
+		goto loop;
 	prdev("no space", dev);
 	u.u_error = ENOSPC;
-	return(NULL);
+	return(0);
 }
 
 /*
@@ -7,6 +7,8 @@
 #define	UMODE	0170000
 #define	SCHMAG	10
 
+struct	proc *agep;	/* next proc entry to be aged */
+
 /*
  * clock is called straight from
  * the real time clock interrupt.
@@ -17,9 +19,10 @@
  *	implement callouts
  *	maintain user/system times
  *	maintain date
- *	profile
+ *	profile (user and kernel)
  *	tout wakeup (sys sleep)
  *	lightning bolt wakeup (every 4 sec)
+ *	age process priorities
  *	alarm clock signals
  *	jab the scheduler
  */
@@ -90,8 +93,13 @@ out:
 		u.u_utime++;
 		if(u.u_prof[3])
 			incupc(pc, u.u_prof);
-	} else
+	} else {
 		u.u_stime++;
+		if(u.u_procp != &proc[0])
+			sysstat.ss_stime++;
+		if(kpflag)
+			kpclock(pc);
+	}
 	pp = u.u_procp;
 	if(++pp->p_cpu == 0)
 		pp->p_cpu--;
@@ -102,22 +110,16 @@ out:
 		if(++time[1] == 0)
 			++time[0];
 		spl1();
-		if(time[1]==tout[1] && time[0]==tout[0])
+		if(time[1]==tout[1] && time[0]==tout[0]) {
 			wakeup(tout);
+			selwakeup();
+		}
 		if((time[1]&03) == 0) {
 			runrun++;
 			wakeup(&lbolt);
 		}
-		for(pp = &proc[0]; pp < &proc[NPROC]; pp++)
-		if (pp->p_stat) {
-			if(pp->p_time != 127)
-				pp->p_time++;
-			if((pp->p_cpu & 0377) > SCHMAG)
-				pp->p_cpu =- SCHMAG; else
-				pp->p_cpu = 0;
-			if(pp->p_pri > PUSER)
-				setpri(pp);
-		}
+		age(&proc[NPROC]);
+		agep = &proc[0];
 		if(runin!=0) {
 			runin = 0;
 			wakeup(&runin);
@@ -128,7 +130,49 @@ out:
 				psig();
 			setpri(u.u_procp);
 		}
+	} else
+	if((ps&0340) == 0) {
+		spl1();
+		age(&proc[lbolt*NPROC/HZ]);
+	}
+}
+
+/*
+ * Age the scheduling parameters of
+ * the proc entries from agep up to ep.
+ * Each entry is aged once a second,
+ * but the work is spread over the
+ * ticks of the second so that the whole
+ * table is not swept in one interrupt.
+ * Entries are claimed one at a time
+ * since a later tick may break in.
+ * The number of entries each call
+ * takes is counted in sysstat, to show
+ * how evenly the work is spread.
+ */
+age(ep)
+{
+	register struct proc *pp;
+	register n;
+
+	if(agep == NULL)
+		agep = &proc[0];
+	n = 0;
+	while(agep < ep) {
+		pp = agep++;
+		n++;
+		if (pp->p_stat) {
+			if(pp->p_time != 127)
+				pp->p_time++;
+			if((pp->p_cpu & 0377) > SCHMAG)
+				pp->p_cpu =- SCHMAG; else
+				pp->p_cpu = 0;
+			if(pp->p_pri > PUSER)
+				setpri(pp);
+		}
 	}
+	if(n)
+		sysstat.ss_age[n<2? 0: n<4? 1: n<16? 2: 3]++;
 }
 
 /*
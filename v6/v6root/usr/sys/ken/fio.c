@@ -51,6 +51,7 @@ int *fp;
 		ip->i_mode =& ~(IREAD|IWRITE);
 		wakeup(ip+1);
 		wakeup(ip+2);
+		selwakeup();
 	}
 	if(rfp->f_count <= 1)
 		closei(rfp->f_inode, rfp->f_flag&FWRITE);
@@ -164,7 +165,7 @@ int *aip;
 			u.u_error = EROFS;
 			return(1);
 		}
-		if(ip->i_flag & ITEXT) {
+		if(ip->i_flag & (ITEXT|IMAP)) {
 			u.u_error = ETXTBSY;
 			return(1);
 		}
@@ -3,6 +3,7 @@
 #include "../systm.h"
 #include "../user.h"
 #include "../inode.h"
+#include "../proc.h"
 #include "../filsys.h"
 #include "../conf.h"
 #include "../buf.h"
@@ -64,6 +65,7 @@ iget(dev, ino) // 参数: (1) dev，设备编号；(2) ino, inode编号
 	int *ip1;
 	register struct mount *ip;
 
+	sysstat.ss_iget++;
 loop:
 	ip = NULL;
 	for(p = &inode[0]; p < &inode[NINODE]; p++) { // 从起始位置遍历inode[]， 寻找未使用的元素，同时确认对象元素是否在inode[]中已经存在
@@ -82,6 +84,7 @@ loop:
 				}
 				panic("no imt");
 			}
+			sysstat.ss_ihit++;
 			p->i_count++; // 如果对象元素既未被加锁，也没有设置IMOUNT标志位的话，递增该元素的参照计数器并加锁，然后返回该元素
 			p->i_flag =| ILOCK;
 			return(p);
@@ -205,8 +208,27 @@ int *tm;
  * algorithm will tend to maintain
  * a contiguous free list much longer
  * than FIFO.
+ * The blocks of large files are
+ * handed to itrd to free later;
+ * until then they are in neither
+ * the file nor the free list.
  */
 
+/*
+ * Truncations waiting for itrd.
+ * t_addr is the i_addr of the file.
+ */
+struct
+{
+	char	t_flag;
+	int	t_dev;
+	int	t_addr[8];
+} itrq[NITRQ];
+
+#define	TBUSY	01		/* blocks waiting to be freed */
+#define	TWANT	02		/* umount or balloc waiting for them */
+#define	TFILL	04		/* taken, inode not yet written */
+
 /*
  * itrun()将参数inode[]元素使用的存储区域的块编号返还给空闲列表，然后将文件长度和inode.i_addr[]全部清0
  * 间接参照时候，将相应的间接块也一并返还到空闲队列，文件数据本身仍保持在块设备的存储空间中，直到该区域被别的数据覆盖
@@ -216,36 +238,122 @@ int *tm;
 itrunc(ip)
 int *ip;
 {
-	register *rp, *bp, *cp;
-	int *dp, *ep;
+	register *rp, *tp, *ap;
+	int *cp;
 
 	rp = ip;
 	if((rp->i_mode&(IFCHR&IFBLK)) != 0) // 如果是特殊文件，则不做任何处理立即返回
 		return;
-	for(ip = &rp->i_addr[7]; ip >= &rp->i_addr[0]; ip--) // 遍历inode.i_addr[]
+	if((rp->i_mode&ILARG) != 0)
+	for(tp = &itrq[0]; tp < &itrq[NITRQ]; tp++)
+	if(tp->t_flag == 0) {
+		/*
+		 * Hand the blocks of a large file
+		 * to itrd once the inode is on
+		 * the disk without them.
+		 */
+		tp->t_flag = TFILL;
+		tp->t_dev = rp->i_dev;
+		ap = &tp->t_addr[0];
+		for(cp = &rp->i_addr[0]; cp < &rp->i_addr[8]; cp++) {
+			*ap++ = *cp;
+			*cp = 0;
+		}
+		rp->i_mode =& ~ILARG;
+		rp->i_size0 = 0;
+		rp->i_size1 = 0;
+		rp->i_flag =| IUPD;
+		iupdat(rp, time);
+		tp->t_flag =& ~TFILL;
+		tp->t_flag =| TBUSY;
+		wakeup(itrq);
+		return;
+	}
+	itfree(rp->i_dev, rp->i_addr, rp->i_mode&ILARG);
+	rp->i_mode =& ~ILARG; // 重置inode[]元素的ILARG标志位，将文件长度设置为0，并设置更新标志位
+	rp->i_size0 = 0;
+	rp->i_size1 = 0;
+	rp->i_flag =| IUPD;
+}
+
+/*
+ * Free the blocks listed in the
+ * 8 word i_addr array aip on dev;
+ * large says the array is indirect.
+ */
+itfree(dev, aip, large)
+int *aip;
+{
+	register *ip, *bp, *cp;
+	int *dp, *ep;
+
+	for(ip = &aip[7]; ip >= &aip[0]; ip--) // 遍历inode.i_addr[]
 	if(*ip) {
-		if((rp->i_mode&ILARG) != 0) { // 如果设置了ILARG标志位，则遍历间接参照块
-			bp = bread(rp->i_dev, *ip); // 读取与inode.i_addr[]元素指向的块编号相对应的块
+		if(large) { // 如果设置了ILARG标志位，则遍历间接参照块
+			bp = bread(dev, *ip); // 读取与inode.i_addr[]元素指向的块编号相对应的块
 			for(cp = bp->b_addr+512; cp >= bp->b_addr; cp--) // 参照块容纳着快编号的队列，从后向前遍历队列，通过执行free()，每次都返还一个块编号给空闲队列
 			if(*cp) {
-				if(ip == &rp->i_addr[7]) { // 因为inode.i_addr[7]供双重间接参照使用，首先读取各块编号所指向的块，再通过free()将其中保存的块编号队列返还给空闲队列
-					dp = bread(rp->i_dev, *cp);
+				if(ip == &aip[7]) { // 因为inode.i_addr[7]供双重间接参照使用，首先读取各块编号所指向的块，再通过free()将其中保存的块编号队列返还给空闲队列
+					dp = bread(dev, *cp);
 					for(ep = dp->b_addr+512; ep >= dp->b_addr; ep--)
 					if(*ep)
-						free(rp->i_dev, *ep);
+						free(dev, *ep);
 					brelse(dp);
 				}
-				free(rp->i_dev, *cp);
+				free(dev, *cp);
 			}
 			brelse(bp);
 		}
-		free(rp->i_dev, *ip); // 执行free(),将inode.i_addr[]元素指向的块编号返还给空闲队列，并将inode.i_addr[]元素的值设置为0
+		free(dev, *ip); // 执行free(),将inode.i_addr[]元素指向的块编号返还给空闲队列，并将inode.i_addr[]元素的值设置为0
 		*ip = 0;
 	}
-	rp->i_mode =& ~ILARG; // 重置inode[]元素的ILARG标志位，将文件长度设置为0，并设置更新标志位
-	rp->i_size0 = 0;
-	rp->i_size1 = 0;
-	rp->i_flag =| IUPD;
+}
+
+/*
+ * The truncation daemon, process 2.
+ * Frees the blocks of the large files
+ * queued in itrq by itrunc, so that
+ * unlink, creat and core need not wait
+ * for the walk through the indirect blocks.
+ */
+itrd()
+{
+	register *tp;
+
+	u.u_procp->p_flag =| SSYS;
+loop:
+	for(tp = &itrq[0]; tp < &itrq[NITRQ]; tp++)
+	if(tp->t_flag&TBUSY) {
+		itfree(tp->t_dev, tp->t_addr, 1);
+		u.u_error = 0;
+		if(tp->t_flag&TWANT)
+			wakeup(tp);
+		tp->t_flag = 0;
+		goto loop;
+	}
+	sleep(itrq, PRIBIO);
+	goto loop;
+}
+
+/*
+ * Wait for the queued truncations
+ * on dev to finish (from umount and
+ * balloc); return 1 if there were any.
+ */
+itrwait(dev)
+{
+	register *tp, n;
+
+	n = 0;
+loop:
+	for(tp = &itrq[0]; tp < &itrq[NITRQ]; tp++)
+	if((tp->t_flag&(TBUSY|TFILL)) && tp->t_dev == dev) {
+		tp->t_flag =| TWANT;
+		sleep(tp, PRIBIO);
+		n = 1;
+		goto loop;
+	}
+	return(n);
 }
 
 /*
@@ -74,7 +74,21 @@ main()
 	}
 	printf("mem = %l\n", maxmem*5/16);
 	maxmem = min(maxmem, MAXMEM);
-	mfree(swapmap, nswap, swplo);
+
+	/*
+	 * Swap is striped across the devices
+	 * in swdevs, each giving as many blocks
+	 * as the smallest of them.
+	 */
+	swapdev = swdevs[0].sw_dev;
+	nswap = swdevs[0].sw_nblk;
+	for(nswdev = 0; nswdev < NSWDEV && swdevs[nswdev].sw_nblk; nswdev++)
+		nswap = min(nswap, swdevs[nswdev].sw_nblk);
+	if(nswdev == 0)
+		panic("no swap");
+	if(nswdev > 1)
+		nswap =& ~(SWINT-1);
+	mfree(swapmap, nswap*nswdev, swplo);
 
 	/*
 	 * determine clock
@@ -114,6 +128,7 @@ main()
 
 	/*
 	 * make init process
+	 * and truncation daemon;
 	 * enter scheduling loop
 	 * with system process
 	 */
@@ -128,6 +143,8 @@ main()
 		 */
 		return;
 	}
+	if(newproc())
+		itrd();
 	sched();
 }
 
@@ -140,6 +157,7 @@ main()
 sureg()
 {
 	register *up, *rp, a;
+	int i;
 
 	a = u.u_procp->p_addr;
 	up = &u.u_uisa[16];
@@ -163,6 +181,17 @@ sureg()
 		if((*rp & WO) == 0)
 			rp[(UISA-UISD)/2] =- a;
 	}
+	if((up=u.u_mfile) != NULL) {
+		a = up->m_caddr;
+		rp = &u.u_uisa[u.u_mseg];
+		for(i=nseg(up->m_size); i; i--) {
+			if(cputype != 40)
+				UISA->r[rp-u.u_uisa+8] = rp[8] + a;
+			if(!u.u_sep)
+				UISA->r[rp-u.u_uisa] = *rp + a;
+			rp++;
+		}
+	}
 }
 
 /*
@@ -173,10 +202,14 @@ sureg()
  * The argument sep specifies if the
  * text and data+stack segments are to
  * be separated.
+ * A mapped file, if any, is laid
+ * read-only over the data segments
+ * from u_mseg on; they must be free.
  */
 estabur(nt, nd, ns, sep)
 {
 	register a, *ap, *dp;
+	int *mp;
 
 	if(sep) {
 		if(cputype == 40)
@@ -186,6 +219,13 @@ estabur(nt, nd, ns, sep)
 	} else
 		if(nseg(nt)+nseg(nd)+nseg(ns) > 8)
 			goto err;
+	if((mp=u.u_mfile) != NULL) {
+		a = nseg(nd);
+		if(!sep)
+			a =+ nseg(nt);
+		if(u.u_mseg < a || u.u_mseg+nseg(mp->m_size) > 8-nseg(ns))
+			goto err;
+	}
 	if(nt+nd+ns+USIZE > maxmem)
 		goto err;
 	a = 0;
@@ -238,6 +278,23 @@ estabur(nt, nd, ns, sep)
 		*--dp = ((128-ns)<<8) | RW | ED;
 		*--ap = a-128;
 	}
+	if(mp != NULL) {
+		a = 0;
+		ap = &u.u_uisa[u.u_mseg];
+		dp = &u.u_uisd[u.u_mseg];
+		if(sep) {
+			ap =+ 8;
+			dp =+ 8;
+		}
+		for(nd = mp->m_size; nd > 0; nd =- 128) {
+			*dp = (((nd>128? 128: nd)-1)<<8) | RO;
+			if(mp->m_flag&MLOAD)
+				*dp =| WO;
+			dp++;
+			*ap++ = a;
+			a =+ 128;
+		}
+	}
 	if(!sep) {
 		ap = &u.u_uisa[0];
 		dp = &u.u_uisa[8];
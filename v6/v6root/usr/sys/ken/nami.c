@@ -106,6 +106,7 @@ cloop: // 从u.u_dirp指向的元素中取出一个元素，之后将对其进
 	 * Set up to search a directory.
 	 */
 
+	sysstat.ss_namei++;
 	u.u_offset[1] = 0; // 由于dp指向与目录相对应的inode[]元素，此后将从dp代表的目录的对应表中寻找与u.u_dbuf容纳的元素名相对应的记录
 	u.u_offset[0] = 0; // 因此，在此处首先进行初始化设定，u.u_count表示目录对应表中的记录数，因为目录的文件长度等于记录数*16, 所以将文件长度除以16(DIRSIZ+2)即可得到记录数
 	u.u_segflg = 1;
@@ -159,6 +160,7 @@ eloop: // 检查目录对应表中一条记录的处理
 	 */
 
 	bcopy(bp->b_addr+(u.u_offset[1]&0777), &u.u_dent, (DIRSIZ+2)/2); // 从块设备缓冲区向u.u_dent复制对应表中的一条记录，u.u_dent.u_ino表示inode编号, u.u_dent.u_name表示文件或者目录名
+	sysstat.ss_dirent++;
 	u.u_offset[1] =+ DIRSIZ+2; // 将u.u_offset[1]与16（一条记录的长度）相加，每处理一条记录，将u.u_count的值减去1
 	u.u_count--;
 	if(u.u_dent.u_ino == 0) { // 如果eo的值为0，则将eo设定为u.u_offset[1]，使eo指向当前目录对应表中空记录之后的一条记录，返回至eloop检查下一条记录
@@ -88,6 +88,7 @@ loop:
 				ip->i_mode =& ~IWRITE;
 				wakeup(ip+1);
 			}
+			selwakeup();
 		}
 
 		/*
@@ -180,9 +181,31 @@ loop:
 		ip->i_mode =& ~IREAD;
 		wakeup(ip+2);
 	}
+	selwakeup();
 	goto loop;
 }
 
+/*
+ * Select on a pipe.
+ * Return true if a read (rw==FREAD) or
+ * a write would not block.
+ * A pipe with only one end is ready
+ * since the read or write returns at once.
+ */
+pipsel(fp, rw)
+int *fp;
+{
+	register *rp, *ip;
+
+	rp = fp;
+	ip = rp->f_inode;
+	if(ip->i_count < 2)
+		return(1);
+	if(rw == FREAD)
+		return(rp->f_offset[1] != ip->i_size1);
+	return(ip->i_size1 < PIPSIZ);
+}
+
 /*
  * Lock a pipe.
  * If its already locked,
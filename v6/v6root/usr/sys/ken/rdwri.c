@@ -152,13 +152,12 @@ char *a, *b;
  * Update all the arguments by the number
  * of bytes moved.
  *
- * There are 2 algorithms,
- * if source address, dest address and count
- * are all even in a user copy,
- * then the machine language copyin/copyout
- * is called.
- * If not, its done byte-by-byte with
- * cpass and passc.
+ * In a user copy, an odd byte at
+ * either end is done with cpass or passc
+ * so that the user address and count
+ * are even; the middle is then moved
+ * by iocopy.
+ * Kernel copies are done byte-by-byte.
  */
 iomove(bp, o, an, flag)
 struct buf *bp;
@@ -168,19 +167,24 @@ struct buf *bp;
 
 	n = an;
 	cp = bp->b_addr + o;
-	if(u.u_segflg==0 && ((n | cp | u.u_base)&01)==0) {
-		if (flag==B_WRITE)
-			cp = copyin(u.u_base, cp, n);
-		else
-			cp = copyout(cp, u.u_base, n);
-		if (cp) {
-			u.u_error = EFAULT;
-			return;
+	if(u.u_segflg==0 && n > 1) {
+		if(u.u_base&01) {
+			if (flag==B_WRITE) {
+				if ((t = cpass()) < 0)
+					return;
+				*cp++ = t;
+			} else {
+				passc(*cp++);
+				if (u.u_error)
+					return;
+			}
+			n--;
 		}
-		u.u_base =+ n;
-		dpadd(u.u_offset, n);
-		u.u_count =- n;
-		return;
+		t = n & ~01;
+		if (iocopy(cp, t, flag))
+			return;
+		cp =+ t;
+		n =- t;
 	}
 	if (flag==B_WRITE) {
 		while(n--) {
@@ -193,3 +197,64 @@ struct buf *bp;
 			if(passc(*cp++) < 0)
 				return;
 }
+
+/*
+ * Move an even number of bytes between
+ * the kernel address cp and the even user
+ * address u.base with the machine language
+ * copyin/copyout.
+ * If cp is odd the words are passed
+ * through an even staging buffer,
+ * which costs a byte loop in the kernel
+ * rather than a fubyte/subyte per byte.
+ * Return non-zero on a fault.
+ */
+iocopy(acp, an, flag)
+char *acp;
+{
+	register char *cp, *p;
+	register int n;
+	int c, r;
+	struct buf *sb;
+
+	cp = acp;
+	sb = NULL;
+	if (cp&01)
+		sb = getblk(NODEV);
+	r = 0;
+	while(an > 0) {
+		c = an;
+		p = cp;
+		if (sb != NULL) {
+			p = sb->b_addr;
+			c = min(c, 512);
+		}
+		if (flag==B_WRITE) {
+			if (copyin(u.u_base, p, c))
+				goto bad;
+			if (p != cp)
+				for(n=0; n<c; n++)
+					cp[n] = p[n];
+		} else {
+			if (p != cp)
+				for(n=0; n<c; n++)
+					p[n] = cp[n];
+			if (copyout(p, u.u_base, c))
+				goto bad;
+		}
+		cp =+ c;
+		an =- c;
+		u.u_base =+ c;
+		dpadd(u.u_offset, c);
+		u.u_count =- c;
+	}
+out:
+	if (sb != NULL)
+		brelse(sb);
+	return(r);
+
+bad:
+	u.u_error = EFAULT;
+	r = 1;
+	goto out;
+}
@@ -8,11 +8,13 @@
 #include "../proc.h"
 #include "../inode.h"
 #include "../reg.h"
+#include "../buf.h"
 
 /*
  * Priority for tracing
  */
 #define	IPCPRI	(-1)
+#define	NIPC	4		/* max simultaneous tracers */
 
 /*
  * Structure to access an array of integers.
@@ -26,9 +28,11 @@ struct
  * Tracing variables.
  * Used to pass trace command from
  * parent to child being traced.
- * This data base cannot be
- * shared and is locked
- * per user.
+ * Each channel is locked by a
+ * tracer for the child (ip_lock)
+ * it is talking to.
+ * Block requests move ip_count
+ * bytes through the buffer ip_bp.
  */
 struct
 {
@@ -36,7 +40,20 @@ struct
 	int	ip_req;
 	int	ip_addr;
 	int	ip_data;
-} ipc;
+	int	ip_count;
+	int	*ip_bp;
+} ipc[NIPC];
+
+/*
+ * A tracer waits here for a channel
+ * to come free. It is not the address
+ * of a channel, where a tracer and its
+ * child wait for each other; otherwise
+ * freeing a channel would wake the
+ * pair on ipc[0] and the child's answer
+ * would wake every tracer waiting.
+ */
+int	ipcwant;
 
 /*
  * Send the specified signal to
@@ -187,7 +204,7 @@ psig()
  */
 core()
 {
-	register s, *ip;
+	register *ip;
 	extern schar;
 
 	u.u_error = 0;
@@ -204,23 +221,89 @@ core()
 	   (ip->i_mode&IFMT) == 0 &&
 	   u.u_uid == u.u_ruid) {
 		itrunc(ip);
-		u.u_offset[0] = 0;
-		u.u_offset[1] = 0;
-		u.u_base = &u;
-		u.u_count = USIZE*64;
-		u.u_segflg = 1;
-		writei(ip);
-		s = u.u_procp->p_size - USIZE;
-		estabur(0, s, 0, 0);
-		u.u_base = 0;
-		u.u_count = s*64;
-		u.u_segflg = 0;
-		writei(ip);
+		cordump(ip);
 	}
 	iput(ip);
 	return(u.u_error==0);
 }
 
+/*
+ * Write the image of the current process,
+ * which lies in consecutive clicks of core
+ * from p_addr, into the empty file aip.
+ * All the blocks are taken from the free list
+ * first and kept in ascending order, so that
+ * each run of consecutive blocks goes to the
+ * disk in one transfer straight from core,
+ * without passing through the buffers.
+ */
+cordump(aip)
+struct inode *aip;
+{
+	register struct inode *ip;
+	register *ap, i;
+	int *bp, *cp, n, s, b, c;
+
+	ip = aip;
+	s = u.u_procp->p_size;
+	n = (s+7) >> 3;
+	bp = NULL;
+	ap = ip->i_addr;
+	if(n > 8) {
+		if((bp = alloc(ip->i_dev)) == NULL)
+			return;
+		ap = bp->b_addr;
+	}
+	for(i=0; i<n; i++) {
+		if((b = balloc(ip->i_dev)) == 0)
+			goto bad;
+		/*
+		 * A buffer may still hold the block
+		 * from the file it last belonged to;
+		 * make sure it is neither written
+		 * over the dump nor read back.
+		 */
+		if(incore(ip->i_dev, b)) {
+			cp = getblk(ip->i_dev, b);
+			cp->b_flags =& ~(B_DONE|B_DELWRI);
+			brelse(cp);
+		}
+		for(c=i; c>0 && ap[c-1]+0100000 > b+0100000; c--)
+			ap[c] = ap[c-1];	/* unsigned compare */
+		ap[c] = b;
+	}
+	if(bp != NULL) {
+		ip->i_addr[0] = bp->b_blkno;
+		ip->i_mode =| ILARG;
+	}
+	ip->i_size0 = (s>>10) & 077;
+	ip->i_size1 = s<<6;
+	ip->i_flag =| IUPD;
+	u.u_procp->p_flag =| SLOCK;
+	for(i=0; i<n && u.u_error==0; i =+ c) {
+		for(c=1; c<64 && i+c<n && ap[i+c]==ap[i]+c; c++)
+			;
+		b = (i+c)<<3;
+		if(b > s)
+			b = s;
+		cwrite(ip->i_dev, ap[i], u.u_procp->p_addr+(i<<3), b-(i<<3));
+	}
+	u.u_procp->p_flag =& ~SLOCK;
+	if(bp != NULL)
+		bdwrite(bp);
+	return;
+
+bad:
+	while(--i >= 0) {
+		free(ip->i_dev, ap[i]);
+		ap[i] = 0;
+	}
+	if(bp != NULL) {
+		free(ip->i_dev, bp->b_blkno);
+		brelse(bp);
+	}
+}
+
 /*
  * grow the stack to include the SP
  * true return if successful.
@@ -256,6 +339,7 @@ char *sp;
 ptrace()
 {
 	register struct proc *p;
+	register *cp;
 
 	if (u.u_arg[2] <= 0) {
 		u.u_procp->p_flag =| STRC;
@@ -270,21 +354,85 @@ ptrace()
 	return;
 
     found:
-	while (ipc.ip_lock)
-		sleep(&ipc, IPCPRI);
-	ipc.ip_lock = p->p_pid;
-	ipc.ip_data = u.u_ar0[R0];
-	ipc.ip_addr = u.u_arg[1] & ~01;
-	ipc.ip_req = u.u_arg[2];
+	for (cp = &ipc[0]; cp->ip_lock; )
+		if (++cp >= &ipc[NIPC]) {
+			sleep(&ipcwant, IPCPRI);
+			cp = &ipc[0];
+		}
+	cp->ip_lock = p->p_pid;
+	cp->ip_addr = u.u_arg[1] & ~01;
+	if (u.u_arg[2] >= 9) {
+		ptblock(p, cp);
+		goto out;
+	}
+	cp->ip_data = u.u_ar0[R0];
+	cp->ip_req = u.u_arg[2];
 	p->p_flag =& ~SWTED;
 	setrun(p);
-	while (ipc.ip_req > 0)
-		sleep(&ipc, IPCPRI);
-	u.u_ar0[R0] = ipc.ip_data;
-	if (ipc.ip_req < 0)
+	while (cp->ip_req > 0)
+		sleep(cp, IPCPRI);
+	u.u_ar0[R0] = cp->ip_data;
+	if (cp->ip_req < 0)
 		u.u_error = EIO;
-	ipc.ip_lock = 0;
-	wakeup(&ipc);
+out:
+	cp->ip_lock = 0;
+	wakeup(&ipcwant);
+}
+
+/*
+ * Block requests.
+ * The r1 bytes at the child's
+ * addr are moved to or from the
+ * tracer's buffer at r0, a system
+ * buffer at a time; the number of
+ * bytes moved is returned.
+ */
+ptblock(ap, acp)
+struct proc *ap;
+{
+	register *cp, *bp, n;
+	int a, c, done;
+
+	cp = acp;
+	bp = getblk(NODEV);
+	cp->ip_bp = bp->b_addr;
+	a = u.u_ar0[R0] & ~01;
+	n = u.u_ar0[R1] & ~01;
+	done = 0;
+	while (n > 0) {
+		if (ap->p_stat != SSTOP || ap->p_pid != cp->ip_lock) {
+			u.u_error = ESRCH;
+			break;
+		}
+		c = n;
+		if (c > 512)
+			c = 512;
+		if (u.u_arg[2] >= 12 && copyin(a, cp->ip_bp, c)) {
+			u.u_error = EFAULT;
+			break;
+		}
+		cp->ip_count = c;
+		cp->ip_req = u.u_arg[2];
+		ap->p_flag =& ~SWTED;
+		setrun(ap);
+		while (cp->ip_req > 0)
+			sleep(cp, IPCPRI);
+		if (cp->ip_req < 0) {
+			if (done == 0)
+				u.u_error = EIO;
+			break;
+		}
+		if (u.u_arg[2] < 12 && copyout(cp->ip_bp, a, c)) {
+			u.u_error = EFAULT;
+			break;
+		}
+		a =+ c;
+		cp->ip_addr =+ c;
+		n =- c;
+		done =+ c;
+	}
+	brelse(bp);
+	u.u_ar0[R0] = done;
 }
 
 /*
@@ -296,53 +444,55 @@ procxmt()
 {
 	register int i;
 	register int *p;
+	register *cp;
 
-	if (ipc.ip_lock != u.u_procp->p_pid)
-		return(0);
-	i = ipc.ip_req;
-	ipc.ip_req = 0;
-	wakeup(&ipc);
+	for (cp = &ipc[0]; cp->ip_lock != u.u_procp->p_pid; )
+		if (++cp >= &ipc[NIPC])
+			return(0);
+	i = cp->ip_req;
+	cp->ip_req = 0;
+	wakeup(cp);
 	switch (i) {
 
 	/* read user I */
 	case 1:
-		if (fuibyte(ipc.ip_addr) == -1)
+		if (fuibyte(cp->ip_addr) == -1)
 			goto error;
-		ipc.ip_data = fuiword(ipc.ip_addr);
+		cp->ip_data = fuiword(cp->ip_addr);
 		break;
 
 	/* read user D */
 	case 2:
-		if (fubyte(ipc.ip_addr) == -1)
+		if (fubyte(cp->ip_addr) == -1)
 			goto error;
-		ipc.ip_data = fuword(ipc.ip_addr);
+		cp->ip_data = fuword(cp->ip_addr);
 		break;
 
 	/* read u */
 	case 3:
-		i = ipc.ip_addr;
+		i = cp->ip_addr;
 		if (i<0 || i >= (USIZE<<6))
 			goto error;
-		ipc.ip_data = u.inta[i>>1];
+		cp->ip_data = u.inta[i>>1];
 		break;
 
 	/* write user I (for now, always an error) */
 	case 4:
-		if (suiword(ipc.ip_addr, 0) < 0)
+		if (suiword(cp->ip_addr, 0) < 0)
 			goto error;
-		suiword(ipc.ip_addr, ipc.ip_data);
+		suiword(cp->ip_addr, cp->ip_data);
 		break;
 
 	/* write user D */
 	case 5:
-		if (suword(ipc.ip_addr, 0) < 0)
+		if (suword(cp->ip_addr, 0) < 0)
 			goto error;
-		suword(ipc.ip_addr, ipc.ip_data);
+		suword(cp->ip_addr, cp->ip_data);
 		break;
 
 	/* write u */
 	case 6:
-		p = &u.inta[ipc.ip_addr>>1];
+		p = &u.inta[cp->ip_addr>>1];
 		if (p >= u.u_fsav && p < &u.u_fsav[25])
 			goto ok;
 		for (i=0; i<9; i++)
@@ -351,24 +501,66 @@ procxmt()
 		goto error;
 	ok:
 		if (p == &u.u_ar0[RPS]) {
-			ipc.ip_data =| 0170000;	/* assure user space */
-			ipc.ip_data =& ~0340;	/* priority 0 */
+			cp->ip_data =| 0170000;	/* assure user space */
+			cp->ip_data =& ~0340;	/* priority 0 */
 		}
-		*p = ipc.ip_data;
+		*p = cp->ip_data;
 		break;
 
 	/* set signal and continue */
 	case 7:
-		u.u_procp->p_sig = ipc.ip_data;
+		u.u_procp->p_sig = cp->ip_data;
 		return(1);
 
 	/* force exit */
 	case 8:
 		exit();
 
+	/* read user I block */
+	case 9:
+		p = cp->ip_bp;
+		for (i=0; i < cp->ip_count; i =+ 2) {
+			if (fuibyte(cp->ip_addr+i) == -1)
+				goto error;
+			*p++ = fuiword(cp->ip_addr+i);
+		}
+		break;
+
+	/* read user D block */
+	case 10:
+		if (copyin(cp->ip_addr, cp->ip_bp, cp->ip_count))
+			goto error;
+		break;
+
+	/* read u block */
+	case 11:
+		i = cp->ip_addr;
+		if (i<0 || i+cp->ip_count > (USIZE<<6))
+			goto error;
+		p = &u.inta[i>>1];
+		for (i=0; i < cp->ip_count; i =+ 2)
+			cp->ip_bp[i>>1] = *p++;
+		break;
+
+	/* write user I block */
+	case 12:
+		p = cp->ip_bp;
+		for (i=0; i < cp->ip_count; i =+ 2) {
+			if (suiword(cp->ip_addr+i, 0) < 0)
+				goto error;
+			suiword(cp->ip_addr+i, *p++);
+		}
+		break;
+
+	/* write user D block */
+	case 13:
+		if (copyout(cp->ip_bp, cp->ip_addr, cp->ip_count))
+			goto error;
+		break;
+
 	default:
 	error:
-		ipc.ip_req = -1;
+		cp->ip_req = -1;
 	}
 	return(0);
 }
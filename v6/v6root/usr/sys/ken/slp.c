@@ -405,6 +405,8 @@ retry:
 		rpp->x_count++;
 		rpp->x_ccount++;
 	}
+	if((rpp=u.u_mfile) != NULL)
+		rpp->m_count++;
 	u.u_cdir->i_count++;
 	/*
 	 * Partially simulate the environment
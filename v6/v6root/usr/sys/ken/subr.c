@@ -197,6 +197,18 @@ nulldev()
 {
 }
 
+/*
+ * Routine which reports a device always
+ * ready; placed in the select entries of
+ * the cdevsw table for devices that do
+ * not block or do not say.
+ */
+seltrue()
+{
+
+	return(1);
+}
+
 /*
  * copy count words from from to to.
  */
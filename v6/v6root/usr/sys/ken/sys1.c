@@ -9,6 +9,7 @@
 #include "../buf.h"
 #include "../reg.h"
 #include "../inode.h"
+#include "../file.h"
 
 /*
  * exec system call.
@@ -24,7 +25,7 @@
 exec()
 {
 	int ap, na, nc, *bp;
-	int ts, ds, sep;
+	int ts, ds, sep, *mp;
 	register c, *ip;
 	register char *cp;
 	extern uchar;
@@ -120,7 +121,11 @@ exec()
 
 	ts = ((u.u_arg[1]+63)>>6) & 01777;
 	ds = ((u.u_arg[2]+u.u_arg[3]+63)>>6) & 01777;
-	if(estabur(ts, ds, SSIZE, sep))
+	mp = u.u_mfile;
+	u.u_mfile = NULL;
+	c = estabur(ts, ds, SSIZE, sep);
+	u.u_mfile = mp;
+	if(c)
 		goto bad;
 
 	/*
@@ -130,6 +135,7 @@ exec()
 	 */
 
 	u.u_prof[3] = 0;
+	mffree();
 	xfree();
 	expand(USIZE);
 	xalloc(ip);
@@ -239,11 +245,12 @@ exit()
 			closef(a);
 		}
 	iput(u.u_cdir);
+	mffree();
 	xfree();
 	a = malloc(swapmap, 1);
 	if(a == NULL)
 		panic("out of swap");
-	p = getblk(swapdev, a);
+	p = getblk(swdev(a), swbno(a));
 	bcopy(&u, p->b_addr, 256);
 	bwrite(p);
 	q = u.u_procp;
@@ -289,7 +296,8 @@ loop:
 		f++;
 		if(p->p_stat == SZOMB) {
 			u.u_ar0[R0] = p->p_pid;
-			bp = bread(swapdev, f=p->p_addr);
+			f = p->p_addr;
+			bp = bread(swdev(f), swbno(f));
 			mfree(swapmap, 1, f);
 			p->p_stat = NULL;
 			p->p_pid = 0;
@@ -405,3 +413,33 @@ bigger:
 	while(d--)
 		clearseg(--a);
 }
+
+/*
+ * map system call.
+ * Map the file open on r0 read-only
+ * into data space at the segment
+ * boundary given; a file of -1
+ * just removes any current map.
+ */
+smap()
+{
+	register *fp, *ip;
+
+	if(u.u_arg[0] & 017777) {
+		u.u_error = EINVAL;
+		return;
+	}
+	mffree();
+	if(u.u_ar0[R0] != -1 && (fp = getf(u.u_ar0[R0])) != NULL) {
+		ip = fp->f_inode;
+		if((fp->f_flag&(FREAD|FPIPE)) != FREAD)
+			u.u_error = EBADF; else
+		if((ip->i_mode&IFMT) != 0)
+			u.u_error = EINVAL; else
+			mfalloc(ip, (u.u_arg[0]>>13) & 07);
+	}
+	if(estabur(u.u_tsize, u.u_dsize, u.u_ssize, u.u_sep)) {
+		mffree();
+		estabur(u.u_tsize, u.u_dsize, u.u_ssize, u.u_sep);
+	}
+}
@@ -5,6 +5,17 @@
 #include "../reg.h"
 #include "../file.h"
 #include "../inode.h"
+#include "../conf.h"
+
+/*
+ * Select variables.
+ * selwant is set by a process about to
+ * wait in select and is the channel it
+ * sleeps on; selseq counts the events
+ * that might have made a file ready.
+ */
+char	selwant;
+int	selseq;
 
 /*
  * read system call
@@ -287,3 +298,107 @@ sslep()
 	}
 	spl0();
 }
+
+/*
+ * select system call
+ * Wait until one of the files in the read
+ * mask (arg 0) can be read or one of those in
+ * the write mask (arg 1) can be written
+ * without blocking, or until the number of
+ * seconds in r0 have passed.
+ * A negative number of seconds waits
+ * indefinitely; zero just polls.
+ * The masks of the ready files are
+ * returned in r0 and r1.
+ */
+select()
+{
+	char *d[2];
+	register rm, wm, seq;
+
+	d[0] = time[0];
+	d[1] = time[1];
+	dpadd(d, u.u_ar0[R0]);
+	for(;;) {
+		seq = selseq;
+		rm = selscan(u.u_arg[0], FREAD);
+		wm = selscan(u.u_arg[1], FWRITE);
+		if(u.u_error || rm || wm || u.u_ar0[R0] == 0)
+			break;
+		spl7();
+		if(u.u_ar0[R0] > 0) {
+			if(dpcmp(d[0], d[1], time[0], time[1]) <= 0) {
+				spl0();
+				break;
+			}
+			if(dpcmp(tout[0], tout[1], time[0], time[1]) <= 0 ||
+			   dpcmp(tout[0], tout[1], d[0], d[1]) > 0) {
+				tout[0] = d[0];
+				tout[1] = d[1];
+			}
+		}
+		if(seq == selseq) {
+			selwant++;
+			sleep(&selwant, PSLEP);
+		}
+		spl0();
+	}
+	u.u_ar0[R0] = rm;
+	u.u_ar0[R1] = wm;
+}
+
+/*
+ * Return the mask of those files in
+ * mask that are ready for reading or
+ * writing (flag).
+ * Pipes and character special files
+ * are asked; anything else is always ready.
+ */
+selscan(mask, flag)
+{
+	register *fp, *ip, m;
+	int i, r;
+
+	r = 0;
+	for(i=0; i<NOFILE; i++) {
+		m = 1<<i;
+		if((mask&m) == 0)
+			continue;
+		fp = getf(i);
+		if(fp == NULL)
+			return(0);
+		if((fp->f_flag&flag) == 0) {
+			u.u_error = EBADF;
+			return(0);
+		}
+		if(fp->f_flag&FPIPE) {
+			if(pipsel(fp, flag))
+				r =| m;
+			continue;
+		}
+		ip = fp->f_inode;
+		if((ip->i_mode&IFMT) == IFCHR) {
+			if((*cdevsw[ip->i_addr[0].d_major].d_select)(ip->i_addr[0], flag))
+				r =| m;
+			continue;
+		}
+		r =| m;
+	}
+	return(r);
+}
+
+/*
+ * Called whenever a tty, pipe or
+ * device may have become ready,
+ * and when a sleep time runs out;
+ * wakes any process waiting in select.
+ */
+selwakeup()
+{
+
+	selseq++;
+	if(selwant) {
+		selwant = 0;
+		wakeup(&selwant);
+	}
+}
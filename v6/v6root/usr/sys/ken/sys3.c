@@ -146,10 +146,12 @@ sumount() // 系统调用umount对应的处理函数，用于卸载指定块设
 	register struct inode *ip;
 	register struct mount *mp;
 
-	update(); // 卸载前，先将内存中数据保存到块设备
 	d = getmdev(); // 取得准备卸载的设备的设备编号
 	if(u.u_error)
 		return;
+loop:
+	itrwait(d);
+	update(); // 卸载前，先将内存中数据保存到块设备
 	for(mp = &mount[0]; mp < &mount[NMOUNT]; mp++) // 在mount[]中寻找与卸载设备相对应的元素
 		if(mp->m_bufp!=NULL && d==mp->m_dev)
 			goto found;
@@ -162,6 +164,12 @@ found:
 			u.u_error = EBUSY;
 			return;
 		}
+	/*
+	 * A truncation queued while update slept
+	 * must be done before the device goes.
+	 */
+	if(itrwait(d))
+		goto loop;
 	(*bdevsw[d.d_major].d_close)(d, 0); // 进行关闭卸载设备的处理
 	ip = mp->m_inodp; // 清除与挂载点相对的inode[]元素的IMOUNT标志位，并释放该元素
 	ip->i_flag =& ~IMOUNT;
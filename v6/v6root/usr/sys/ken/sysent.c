@@ -37,9 +37,9 @@ int	sysent[]
 	0, &getuid,			/* 24 = getuid */
 	0, &stime,			/* 25 = stime */
 	3, &ptrace,			/* 26 = ptrace */
-	0, &nosys,			/* 27 = x */
+	2, &select,			/* 27 = select */
 	1, &fstat,			/* 28 = fstat */
-	0, &nosys,			/* 29 = x */
+	1, &smap,			/* 29 = map */
 	1, &nullsys,			/* 30 = smdate; inoperative */
 	1, &stty,			/* 31 = stty */
 	1, &gtty,			/* 32 = gtty */
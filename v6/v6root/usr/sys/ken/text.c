@@ -154,3 +154,93 @@ int *xp;
 		if(--rp->x_ccount == 0)
 			mfree(coremap, rp->x_size, rp->x_caddr);
 }
+
+/*
+ * Map the inode ip read-only into
+ * data space starting at segment seg.
+ * The first process to map a file
+ * reads it into core through the map
+ * itself; later ones share that copy.
+ * The caller must estabur again
+ * to make the map read-only.
+ */
+mfalloc(ip, seg)
+int *ip;
+{
+	register struct mfile *mp;
+	register *rp;
+	int *ep, ms;
+
+	rp = ip;
+	if(rp->i_size0 || rp->i_size1 == 0) {
+		u.u_error = EINVAL;
+		return;
+	}
+	plock(rp);
+	ep = NULL;
+	for(mp = &mfile[0]; mp < &mfile[NMFILE]; mp++)
+		if(mp->m_iptr == NULL) {
+			if(ep == NULL)
+				ep = mp;
+		} else
+			if(mp->m_iptr == rp) {
+				mp->m_count++;
+				u.u_mfile = mp;
+				u.u_mseg = seg;
+				goto out;
+			}
+	if((mp=ep) == NULL) {
+		u.u_error = ENFILE;
+		goto out;
+	}
+	ms = ((rp->i_size1+63)>>6) & 01777;
+	if((mp->m_caddr = malloc(coremap, ms)) == NULL) {
+		u.u_error = ENOMEM;
+		goto out;
+	}
+	mp->m_size = ms;
+	mp->m_count = 1;
+	mp->m_iptr = rp;
+	mp->m_flag = MLOAD;
+	rp->i_flag =| IMAP;
+	rp->i_count++;
+	u.u_mfile = mp;
+	u.u_mseg = seg;
+	if(estabur(u.u_tsize, u.u_dsize, u.u_ssize, u.u_sep))
+		goto out;
+	clearseg(mp->m_caddr+ms-1);
+	u.u_base = seg<<13;
+	u.u_count = rp->i_size1;
+	u.u_offset[0] = 0;
+	u.u_offset[1] = 0;
+	u.u_segflg = 0;
+	readi(rp);
+	mp->m_flag = 0;
+
+out:
+	if(u.u_error)
+		mffree();
+	prele(rp);
+}
+
+/*
+ * Relinquish the mapped file of a process.
+ * The core copy goes when the last
+ * process lets go of it.
+ */
+mffree()
+{
+	register struct mfile *mp;
+	register *ip;
+
+	if((mp=u.u_mfile) != NULL) {
+		u.u_mfile = NULL;
+		if(--mp->m_count == 0) {
+			ip = mp->m_iptr;
+			mp->m_iptr = NULL;
+			mfree(coremap, mp->m_size, mp->m_caddr);
+			ip->i_flag =& ~IMAP;
+			iput(ip);
+		}
+	}
+}
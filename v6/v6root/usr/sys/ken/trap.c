@@ -100,6 +100,7 @@ trap(dev, sp, r1, nps, r0, pc, ps)
 	case 6+USER: /* sys call */
 		u.u_error = 0;
 		ps =& ~EBIT;
+		sysstat.ss_syscall++;
 		callp = &sysent[fuiword(pc-2)&077];
 		if (callp == sysent) { /* indirect */
 			a = fuiword(pc);
@@ -17,6 +17,11 @@
 #define	NCALL	20		/* max simultaneous time callouts */
 #define	NPROC	50		/* max number of processes */ // 系统中同时存在的最大进程数
 #define	NTEXT	40		/* max number of pure texts */
+#define	NMFILE	8		/* max number of mapped files */
+#define	NSWDEV	4		/* max number of swap devices */
+#define	SWINT	8		/* swap interleave (blocks) */
+#define	NITRQ	10		/* max truncations waiting for itrd */
+#define	NTBUF	4		/* raw tape writes queued per controller */
 #define	NCLIST	100		/* max total clist size */
 #define	HZ	60		/* Ticks/second of the clock */
 
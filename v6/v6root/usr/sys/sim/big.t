@@ -0,0 +1,567 @@
+# one big file: write it, read it
+# through, then here and there
+creat /big 0666
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+write 3 8192
+close 3
+open /big 0
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+read 3 8192
+seek 3 815 3
+read 3 512
+seek 3 999 3
+read 3 512
+seek 3 323 3
+read 3 512
+seek 3 595 3
+read 3 512
+seek 3 1146 3
+read 3 512
+seek 3 12 3
+read 3 512
+seek 3 1277 3
+read 3 512
+seek 3 920 3
+read 3 512
+seek 3 116 3
+read 3 512
+seek 3 373 3
+read 3 512
+seek 3 61 3
+read 3 512
+seek 3 1249 3
+read 3 512
+seek 3 1166 3
+read 3 512
+seek 3 229 3
+read 3 512
+seek 3 759 3
+read 3 512
+seek 3 741 3
+read 3 512
+seek 3 1018 3
+read 3 512
+seek 3 1207 3
+read 3 512
+seek 3 127 3
+read 3 512
+seek 3 394 3
+read 3 512
+seek 3 316 3
+read 3 512
+seek 3 551 3
+read 3 512
+seek 3 1256 3
+read 3 512
+seek 3 30 3
+read 3 512
+seek 3 864 3
+read 3 512
+seek 3 1074 3
+read 3 512
+seek 3 1006 3
+read 3 512
+seek 3 155 3
+read 3 512
+seek 3 960 3
+read 3 512
+seek 3 475 3
+read 3 512
+seek 3 205 3
+read 3 512
+seek 3 759 3
+read 3 512
+seek 3 741 3
+read 3 512
+seek 3 296 3
+read 3 512
+seek 3 498 3
+read 3 512
+seek 3 1242 3
+read 3 512
+seek 3 651 3
+read 3 512
+seek 3 295 3
+read 3 512
+seek 3 77 3
+read 3 512
+seek 3 199 3
+read 3 512
+seek 3 215 3
+read 3 512
+seek 3 92 3
+read 3 512
+seek 3 978 3
+read 3 512
+seek 3 947 3
+read 3 512
+seek 3 141 3
+read 3 512
+seek 3 63 3
+read 3 512
+seek 3 1129 3
+read 3 512
+seek 3 260 3
+read 3 512
+seek 3 1262 3
+read 3 512
+seek 3 171 3
+read 3 512
+seek 3 329 3
+read 3 512
+seek 3 1265 3
+read 3 512
+seek 3 543 3
+read 3 512
+seek 3 925 3
+read 3 512
+seek 3 1023 3
+read 3 512
+seek 3 41 3
+read 3 512
+seek 3 280 3
+read 3 512
+seek 3 386 3
+read 3 512
+seek 3 902 3
+read 3 512
+seek 3 981 3
+read 3 512
+seek 3 900 3
+read 3 512
+seek 3 915 3
+read 3 512
+seek 3 1143 3
+read 3 512
+seek 3 566 3
+read 3 512
+seek 3 977 3
+read 3 512
+seek 3 1186 3
+read 3 512
+seek 3 130 3
+read 3 512
+seek 3 597 3
+read 3 512
+seek 3 744 3
+read 3 512
+seek 3 585 3
+read 3 512
+seek 3 737 3
+read 3 512
+seek 3 69 3
+read 3 512
+seek 3 171 3
+read 3 512
+seek 3 1028 3
+read 3 512
+seek 3 564 3
+read 3 512
+seek 3 573 3
+read 3 512
+seek 3 561 3
+read 3 512
+seek 3 968 3
+read 3 512
+seek 3 882 3
+read 3 512
+seek 3 909 3
+read 3 512
+seek 3 760 3
+read 3 512
+seek 3 65 3
+read 3 512
+seek 3 175 3
+read 3 512
+seek 3 511 3
+read 3 512
+seek 3 1238 3
+read 3 512
+seek 3 488 3
+read 3 512
+seek 3 1096 3
+read 3 512
+seek 3 66 3
+read 3 512
+seek 3 354 3
+read 3 512
+seek 3 688 3
+read 3 512
+seek 3 758 3
+read 3 512
+seek 3 65 3
+read 3 512
+seek 3 106 3
+read 3 512
+seek 3 428 3
+read 3 512
+seek 3 886 3
+read 3 512
+seek 3 703 3
+read 3 512
+seek 3 158 3
+read 3 512
+seek 3 322 3
+read 3 512
+seek 3 233 3
+read 3 512
+seek 3 818 3
+read 3 512
+seek 3 1120 3
+read 3 512
+seek 3 277 3
+read 3 512
+seek 3 950 3
+read 3 512
+seek 3 1012 3
+read 3 512
+seek 3 153 3
+read 3 512
+seek 3 262 3
+read 3 512
+seek 3 151 3
+read 3 512
+seek 3 717 3
+read 3 512
+seek 3 1065 3
+read 3 512
+seek 3 62 3
+read 3 512
+seek 3 380 3
+read 3 512
+seek 3 1076 3
+read 3 512
+seek 3 307 3
+read 3 512
+seek 3 376 3
+read 3 512
+seek 3 576 3
+read 3 512
+seek 3 309 3
+read 3 512
+seek 3 1038 3
+read 3 512
+seek 3 1164 3
+read 3 512
+seek 3 795 3
+read 3 512
+seek 3 456 3
+read 3 512
+seek 3 453 3
+read 3 512
+seek 3 1155 3
+read 3 512
+seek 3 257 3
+read 3 512
+seek 3 858 3
+read 3 512
+seek 3 334 3
+read 3 512
+seek 3 648 3
+read 3 512
+seek 3 492 3
+read 3 512
+seek 3 1148 3
+read 3 512
+seek 3 1172 3
+read 3 512
+seek 3 9 3
+read 3 512
+seek 3 1165 3
+read 3 512
+seek 3 791 3
+read 3 512
+seek 3 385 3
+read 3 512
+seek 3 666 3
+read 3 512
+seek 3 780 3
+read 3 512
+seek 3 1077 3
+read 3 512
+seek 3 903 3
+read 3 512
+seek 3 19 3
+read 3 512
+seek 3 814 3
+read 3 512
+seek 3 1087 3
+read 3 512
+seek 3 1128 3
+read 3 512
+seek 3 279 3
+read 3 512
+seek 3 478 3
+read 3 512
+seek 3 1113 3
+read 3 512
+seek 3 762 3
+read 3 512
+seek 3 556 3
+read 3 512
+seek 3 379 3
+read 3 512
+seek 3 305 3
+read 3 512
+seek 3 336 3
+read 3 512
+seek 3 275 3
+read 3 512
+seek 3 787 3
+read 3 512
+seek 3 152 3
+read 3 512
+seek 3 125 3
+read 3 512
+seek 3 25 3
+read 3 512
+seek 3 81 3
+read 3 512
+seek 3 967 3
+read 3 512
+seek 3 121 3
+read 3 512
+seek 3 234 3
+read 3 512
+seek 3 1106 3
+read 3 512
+seek 3 205 3
+read 3 512
+seek 3 752 3
+read 3 512
+seek 3 1219 3
+read 3 512
+seek 3 65 3
+read 3 512
+seek 3 122 3
+read 3 512
+seek 3 1111 3
+read 3 512
+seek 3 460 3
+read 3 512
+seek 3 833 3
+read 3 512
+seek 3 461 3
+read 3 512
+seek 3 1157 3
+read 3 512
+seek 3 601 3
+read 3 512
+seek 3 189 3
+read 3 512
+seek 3 964 3
+read 3 512
+seek 3 158 3
+read 3 512
+seek 3 1174 3
+read 3 512
+seek 3 120 3
+read 3 512
+seek 3 345 3
+read 3 512
+seek 3 896 3
+read 3 512
+seek 3 245 3
+read 3 512
+seek 3 229 3
+read 3 512
+seek 3 364 3
+read 3 512
+seek 3 102 3
+read 3 512
+seek 3 62 3
+read 3 512
+seek 3 871 3
+read 3 512
+seek 3 587 3
+read 3 512
+seek 3 523 3
+read 3 512
+seek 3 908 3
+read 3 512
+seek 3 475 3
+read 3 512
+seek 3 413 3
+read 3 512
+seek 3 1096 3
+read 3 512
+seek 3 438 3
+read 3 512
+seek 3 568 3
+read 3 512
+seek 3 1212 3
+read 3 512
+seek 3 26 3
+read 3 512
+seek 3 522 3
+read 3 512
+seek 3 1079 3
+read 3 512
+seek 3 677 3
+read 3 512
+seek 3 1059 3
+read 3 512
+seek 3 191 3
+read 3 512
+seek 3 1197 3
+read 3 512
+seek 3 1219 3
+read 3 512
+close 3
+unlink /big
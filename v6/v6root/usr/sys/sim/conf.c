@@ -0,0 +1,33 @@
+/*
+ * Configuration of the simulator,
+ * in the form mkconf gives c.c:
+ * the simulated disk is block and
+ * character device 0, the root.
+ */
+
+int	simstrategy();
+int	simtab[5];	/* struct devtab */
+int	nulldev();
+int	nodev();
+
+int	(*bdevsw[])()
+{
+	&nulldev,	&nulldev,	&simstrategy, 	&simtab,	/* sim = 0 */
+	0
+};
+
+int	(*cdevsw[])()
+{
+	&nulldev,	&nulldev,	&nodev,		&nodev,		&nodev,		&nodev,	/* sim = 0 */
+	0
+};
+
+int	rootdev	{(0<<8)|0};
+int	swplo	4000;	/* cannot be zero */
+int	rdsize	200;
+
+int	swdevs[]
+{
+	(0<<8)|0,	872,
+	0,	0
+};
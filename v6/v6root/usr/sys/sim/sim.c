@@ -0,0 +1,969 @@
+/*
+ * sim - run the file system code of
+ * the kernel on a simulated disk.
+ *
+ *	sim [-d rk|rp] [-n blocks] [-i image] [-c us] [-s n] [-v] trace ...
+ *
+ * The kernel's own bio.c, iget.c, alloc.c,
+ * nami.c, rdwri.c, fio.c, sys2-4.c and pipe.c,
+ * put through tran, run on one process
+ * with the simulated disk of conf.c as
+ * root.  A trace is a list of system
+ * calls, one a line:
+ *
+ *	open path mode		creat path mode
+ *	read fd n		write fd n
+ *	seek fd off whence	close fd
+ *	link path path		unlink path
+ *	mknod path mode dev	chmod path mode
+ *	mkdir path		rmdir path
+ *	chdir path		stat path
+ *	fstat fd		sync
+ *
+ * with # for comments; numbers are
+ * read as in C.  mkdir and rmdir are
+ * the calls /bin/mkdir and /bin/rmdir
+ * make.  Each call is handed to the
+ * kernel's handler as trap would, and
+ * the report gives for each sort of call
+ * the memory references made by the
+ * kernel (simulated cpu at -c us a
+ * reference), the disk time, the blocks
+ * read and written and the counts of
+ * sysstat (buffer hits, in-core inodes,
+ * directories searched).
+ *
+ * The disk is an rk05 (-d rk) or an rp03
+ * (-d rp): seek time goes with the
+ * cylinders crossed, the rotation is
+ * kept from the simulated clock and
+ * every transfer ends before the next
+ * begins, so delayed and asynchronous
+ * writes cost their time at once.
+ * -n makes the file system smaller than
+ * the disk; -i keeps it in a file from
+ * one run to the next (and makes it, as
+ * mkfs would, when there is none); -s
+ * syncs every n calls as update would.
+ *
+ * There is only one process: a sleep is
+ * a fault, and the truncations itrunc
+ * leaves for itrd are done after each
+ * call.
+ */
+#include <time.h>
+#include <math.h>
+#include "sim.h"
+#include "k.h"
+#include "k.p"
+
+unsigned char mem[0200000];
+int	ksp = STKTOP;
+long	nref;
+
+/* user space */
+#define	AR0	(UBASE+040)	/* saved registers */
+#define	PATH1	(UBASE+0100)
+#define	PATH2	(UBASE+0500)
+#define	STATB	(UBASE+01100)
+#define	DATA	(UBASE+02000)
+#define	MAXIO	(STKLIM-DATA)
+
+/*
+ * Disks.
+ */
+struct disk {
+	char	*name;
+	int	ncyl;
+	int	ntrk;
+	int	nsec;
+	double	rev;		/* us a turn */
+	double	seek0;		/* us to move at all */
+	double	seek1;		/* us a cylinder more */
+	int	fn, fm;		/* free list interleave of mkfs */
+} disks[] = {
+	{ "rk05", 203, 2, 12, 40000.0, 10000.0, 375.0, 24, 3 },
+	{ "rp03", 406, 20, 10, 16667.0, 7500.0, 117.0, 10, 4 },
+	{ 0 }
+};
+struct disk *dk = &disks[0];
+
+unsigned char *image;
+int	nblock;
+int	cyl;			/* where the heads are */
+double	now;			/* simulated us */
+double	usref = 1.0;
+long	lastref;
+int	vflag;
+
+/*
+ * Counts, for a sort of call
+ * and for all.
+ */
+struct count {
+	long	n;
+	long	err;
+	long	refs;
+	double	dtime;
+	long	rd, wr;
+	long	cyls;
+	long	ss[8];		/* sysstat */
+};
+
+struct call {
+	char	*name;
+	int	nargs;		/* words after the name */
+	int	paths;		/* which of them are paths (bits) */
+	struct count c;
+} calls[] = {
+	{ "open", 2, 1 },
+	{ "creat", 2, 1 },
+	{ "read", 2, 0 },
+	{ "write", 2, 0 },
+	{ "seek", 3, 0 },
+	{ "close", 1, 0 },
+	{ "link", 2, 3 },
+	{ "unlink", 1, 1 },
+	{ "mknod", 3, 1 },
+	{ "chmod", 2, 1 },
+	{ "mkdir", 1, 1 },
+	{ "rmdir", 1, 1 },
+	{ "chdir", 1, 1 },
+	{ "stat", 1, 1 },
+	{ "fstat", 1, 0 },
+	{ "sync", 0, 0 },
+	{ 0 }
+};
+struct count total;
+struct count bootc;
+struct count *cur = &bootc;	/* charged with the disk */
+double	start;			/* now, at the first call */
+
+char	*tname;			/* where in the trace */
+int	tline;
+
+void
+fault(char *s, int a)
+{
+	fprintf(stderr, "sim: %s: 0%o", s, a & 0177777);
+	if(tname)
+		fprintf(stderr, " at %s:%d", tname, tline);
+	fprintf(stderr, "\n");
+	exit(2);
+}
+
+/*
+ * Simulated time: the kernel's
+ * references since the last look.
+ */
+void
+tick(void)
+{
+	now += (nref-lastref) * usref;
+	lastref = nref;
+}
+
+int
+rw(int a)
+{
+	return mem[a] | mem[a+1]<<8;
+}
+
+void
+ww(int a, int v)
+{
+	mem[a] = v;
+	mem[a+1] = v>>8;
+}
+
+/*
+ * The strategy routine of the disk,
+ * as a driver would with an interrupt
+ * at once.
+ */
+int
+k_simstrategy(int bp, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	int flag, bn, n, ma, c, s;
+	double t, w;
+
+	tick();
+	flag = rw(bp+M_b_flags);
+	bn = rw(bp+M_b_blkno);
+	ma = rw(bp+M_b_addr);
+	n = -I(rw(bp+M_b_wcount)) * 2;
+	if(flag & D_B_PHYS || bp < LOWMEM)
+		fault("raw i/o", bp);
+	if(bn+(n+511)/512 > nblock || ma+n > 0200000) {
+		ww(bp+M_b_flags, flag | D_B_ERROR);
+		k_iodone(bp, 0, 0, 0, 0, 0, 0, 0);
+		return 0;
+	}
+	c = bn / (dk->ntrk*dk->nsec);
+	s = bn % dk->nsec;
+	t = now;
+	if(c != cyl) {
+		now += dk->seek0 + abs(c-cyl)*dk->seek1;
+		cur->cyls += abs(c-cyl);
+		cyl = c;
+	}
+	/* round to the sector */
+	w = fmod(s*dk->rev/dk->nsec - fmod(now, dk->rev) + dk->rev, dk->rev);
+	now += w + (n+511)/512 * dk->rev/dk->nsec;
+	cur->dtime += now-t;
+	if(flag & D_B_READ) {
+		memcpy(&mem[ma], &image[bn*512], n);
+		cur->rd++;
+	} else {
+		memcpy(&image[bn*512], &mem[ma], n);
+		cur->wr++;
+	}
+	lastref = nref;
+	k_iodone(bp, 0, 0, 0, 0, 0, 0, 0);
+	return 0;
+}
+
+/*
+ * The machine language of m40.s.
+ */
+int
+k_spl0(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	return 0;
+}
+
+int
+k_spl6(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	return 0;
+}
+
+int
+k_spl7(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	return 0;
+}
+
+int
+k_savu(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	fault("the process sleeps on", rw(G_proc+M_p_wchan));
+	return 0;
+}
+
+int
+k_retu(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	fault("retu", a0);
+	return 0;
+}
+
+int
+k_aretu(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	fault("aretu", a0);
+	return 0;
+}
+
+int
+k_idle(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	fault("idle", 0);
+	return 0;
+}
+
+int
+k_xswap(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	fault("swap", a0);
+	return 0;
+}
+
+int
+k_sureg(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	return 0;
+}
+
+int
+k_copyseg(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	fault("copyseg", a0);
+	return 0;
+}
+
+int
+k_pcopy(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	fault("pcopy", a0);
+	return 0;
+}
+
+int
+k_issig(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	return 0;
+}
+
+int
+k_psignal(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	return 0;
+}
+
+/* user space is mem too */
+int
+k_copyin(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	a0 = P(a0);
+	a1 = P(a1);
+	a2 = P(a2);
+	if(a0 < UBASE || a0+a2 > STKLIM)
+		return -1;
+	memmove(&mem[a1], &mem[a0], a2);
+	nref += a2/2;
+	return 0;
+}
+
+int
+k_copyout(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	a0 = P(a0);
+	a1 = P(a1);
+	a2 = P(a2);
+	if(a1 < UBASE || a1+a2 > STKLIM)
+		return -1;
+	memmove(&mem[a1], &mem[a0], a2);
+	nref += a2/2;
+	return 0;
+}
+
+int
+k_fubyte(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	a0 = P(a0);
+	if(a0 < UBASE || a0 >= STKLIM)
+		return -1;
+	nref++;
+	return mem[a0];
+}
+
+int
+k_subyte(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	a0 = P(a0);
+	if(a0 < UBASE || a0 >= STKLIM)
+		return -1;
+	nref++;
+	mem[a0] = a1;
+	return 0;
+}
+
+int
+k_fuword(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	a0 = P(a0);
+	if(a0 < UBASE || a0 >= STKLIM-1 || a0&1)
+		return -1;
+	nref++;
+	return I(rw(a0));
+}
+
+int
+k_suword(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	a0 = P(a0);
+	if(a0 < UBASE || a0 >= STKLIM-1 || a0&1)
+		return -1;
+	nref++;
+	ww(a0, a1);
+	return 0;
+}
+
+/* the word a0, unsigned, by a1 */
+int
+k_ldiv(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	return I(P(a0) / I(a1));
+}
+
+int
+k_lrem(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	return I(P(a0) % I(a1));
+}
+
+int
+k_lshift(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	long n;
+
+	n = (long)(short)LW(a0)<<16 | P(LW(a0+2));
+	a1 = I(a1);
+	if(a1 >= 0)
+		n <<= a1;
+	else
+		n >>= -a1;
+	return I(n);
+}
+
+int
+k_dpadd(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	long n;
+
+	n = P(LW(a0+2)) + (long)P(a1);
+	SW(a0+2, n);
+	if(n >= 0200000)
+		SW(a0, LW(a0)+1);
+	return 0;
+}
+
+int
+k_dpcmp(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	long d;
+
+	d = ((long)I(a0)<<16 | P(a1)) - ((long)I(a2)<<16 | P(a3));
+	if(d > 512)
+		return 512;
+	if(d < -512)
+		return -512;
+	return d;
+}
+
+/*
+ * printf of prf.c, on the standard error.
+ */
+void
+kstr(int a)
+{
+	int c;
+
+	while((c = mem[P(a)]) != 0) {
+		putc(c, stderr);
+		a++;
+	}
+}
+
+int
+k_printf(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	int args[7], *ap, c;
+
+	args[0] = a1; args[1] = a2; args[2] = a3; args[3] = a4;
+	args[4] = a5; args[5] = a6; args[6] = a7;
+	ap = args;
+	while((c = mem[P(a0++)]) != 0) {
+		if(c != '%') {
+			putc(c, stderr);
+			continue;
+		}
+		c = mem[P(a0++)];
+		if(ap >= args+7)
+			break;
+		switch(c) {
+		case 'd':
+			fprintf(stderr, "%d", I(*ap++));
+			break;
+		case 'l':
+			fprintf(stderr, "%u", P(*ap++));
+			break;
+		case 'o':
+			fprintf(stderr, "%o", P(*ap++));
+			break;
+		case 'c':
+			putc(*ap++, stderr);
+			break;
+		case 's':
+			kstr(*ap++);
+			break;
+		}
+	}
+	return 0;
+}
+
+int
+k_prdev(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	fprintf(stderr, "kernel: ");
+	kstr(a0);
+	fprintf(stderr, " on dev %d/%d\n", P(a1)>>8, a1&0377);
+	return 0;
+}
+
+int
+k_panic(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	fprintf(stderr, "panic: ");
+	kstr(a0);
+	fprintf(stderr, "\n");
+	fault("panic", 0);
+	return 0;
+}
+
+/*
+ * Make a file system, as mkfs
+ * does with a size for its proto.
+ */
+int	fsfree[100], nfsfree;
+
+void
+bfree(int bn)
+{
+	int i;
+
+	if(nfsfree >= 100) {
+		ww(DATA, nfsfree);
+		for(i = 0; i < 100; i++)
+			ww(DATA+2+2*i, fsfree[i]);
+		memcpy(&image[bn*512], &mem[DATA], 512);
+		nfsfree = 0;
+	}
+	fsfree[nfsfree++] = bn;
+}
+
+int
+balloc(void)
+{
+	int bn, i;
+
+	bn = fsfree[--nfsfree];
+	if(bn == 0)
+		fault("mkfs: no space", 0);
+	if(nfsfree <= 0) {
+		memcpy(&mem[DATA], &image[bn*512], 512);
+		nfsfree = rw(DATA);
+		for(i = 0; i < 100; i++)
+			fsfree[i] = rw(DATA+2+2*i);
+	}
+	return bn;
+}
+
+void
+mkfs(void)
+{
+	unsigned char *ip, *dp;
+	int isize, adr[100], flg[100], i, j, hi, lo, bn;
+
+	memset(image, 0, nblock*512);
+	isize = nblock / (43 + nblock/1000);
+	for(i = 0; i < dk->fn; i++)
+		flg[i] = 0;
+	i = 0;
+	for(j = 0; j < dk->fn; j++) {
+		while(flg[i])
+			i = (i+1) % dk->fn;
+		adr[j] = i;
+		flg[i]++;
+		i = (i+dk->fm) % dk->fn;
+	}
+	hi = nblock-1;
+	lo = isize+2;
+	nfsfree = 0;
+	bfree(0);
+	for(i = hi; (i+1) % dk->fn; i--) {
+		if(i < lo)
+			break;
+		bfree(i);
+	}
+	for(; i >= lo+dk->fn; i -= dk->fn)
+		for(j = 0; j < dk->fn; j++)
+			bfree(i-adr[j]);
+	for(; i >= lo; i--)
+		bfree(i);
+
+	/* the root, i-number 1 */
+	bn = balloc();
+	ip = &image[2*512];
+	ip[0] = (D_IALLOC|D_IFDIR|0777) & 0377;
+	ip[1] = (D_IALLOC|D_IFDIR|0777) >> 8;
+	ip[2] = 2;			/* i_nlink */
+	ip[6] = 32;			/* i_size1 */
+	ip[8] = bn;			/* i_addr[0] */
+	ip[9] = bn >> 8;
+	dp = &image[bn*512];
+	dp[0] = 1;
+	dp[2] = '.';
+	dp[16] = 1;
+	dp[18] = '.';
+	dp[19] = '.';
+
+	/* the super block */
+	memset(&mem[DATA], 0, 512);
+	ww(DATA+M_s_isize, isize);
+	ww(DATA+M_s_fsize, nblock);
+	ww(DATA+M_s_nfree, nfsfree);
+	for(i = 0; i < 100; i++)
+		ww(DATA+M_s_free+2*i, fsfree[i]);
+	memcpy(&image[512], &mem[DATA], 512);
+	printf("sim: made %s, %d blocks, isize %d, free list %d/%d\n",
+	    dk->name, nblock, isize, dk->fm, dk->fn);
+}
+
+/*
+ * Start the kernel as main does,
+ * less the processes.
+ */
+void
+boot(void)
+{
+	int ip;
+
+	k_init();
+	ww(G_proc+M_p_stat, D_SRUN);
+	ww(G_proc+M_p_flag, D_SLOAD|D_SSYS);
+	ww(G_u+M_u_procp, G_proc);
+	ww(G_u+M_u_ar0, AR0);
+	k_binit(0, 0, 0, 0, 0, 0, 0, 0);
+	k_iinit(0, 0, 0, 0, 0, 0, 0, 0);
+	ip = k_iget(rw(G_rootdev), D_ROOTINO, 0, 0, 0, 0, 0, 0);
+	ww(G_rootdir, ip);
+	ww(ip+M_i_flag, rw(ip+M_i_flag) & ~D_ILOCK);
+	ip = k_iget(rw(G_rootdev), D_ROOTINO, 0, 0, 0, 0, 0, 0);
+	ww(G_u+M_u_cdir, ip);
+	ww(ip+M_i_flag, rw(ip+M_i_flag) & ~D_ILOCK);
+}
+
+/*
+ * Free what itrunc queued for itrd,
+ * as itrd would.
+ */
+void
+itrd(void)
+{
+	int tp;
+
+	for(tp = G_itrq; tp < G_itrq+Z_itrq; tp += Z_itrq/D_NITRQ)
+		if(mem[tp+M_t_flag] & D_TBUSY) {
+			k_itfree(rw(tp+M_t_dev), tp+M_t_addr, 1, 0, 0, 0, 0, 0);
+			mem[G_u+M_u_error] = 0;
+			mem[tp+M_t_flag] = 0;
+		}
+}
+
+/*
+ * One system call, as trap makes it.
+ */
+int
+sys(int (*f)(), int r0, int a0, int a1, int a2)
+{
+	ww(AR0, r0);
+	ww(G_u+M_u_arg, a0);
+	ww(G_u+M_u_arg+2, a1);
+	ww(G_u+M_u_arg+4, a2);
+	ww(G_u+M_u_dirp, a0);
+	mem[G_u+M_u_error] = 0;
+	mem[G_u+M_u_segflg] = 0;
+	(*f)(0, 0, 0, 0, 0, 0, 0, 0);
+	if(ksp != STKTOP)
+		fault("stack left at", ksp);
+	itrd();
+	return mem[G_u+M_u_error];
+}
+
+void
+setpath(int a, char *s)
+{
+	int n;
+
+	n = strlen(s);
+	if(n > 0377)
+		fault("path too long", n);
+	memcpy(&mem[a], s, n+1);
+}
+
+/* the parent of a path, for mkdir */
+char *
+parent(char *s, char *buf)
+{
+	char *p;
+
+	strcpy(buf, s);
+	p = strrchr(buf, '/');
+	if(p == 0)
+		return ".";
+	if(p == buf)
+		p++;
+	*p = 0;
+	return buf;
+}
+
+int
+docall(struct call *cp, char **av, int *v)
+{
+	char buf[600];
+	int e;
+
+	switch(cp-calls) {
+	case 0:
+		return sys(k_open, 0, PATH1, v[1], 0);
+	case 1:
+		return sys(k_creat, 0, PATH1, v[1], 0);
+	case 2:
+		if(P(v[1]) > MAXIO)
+			fault("read too big", v[1]);
+		return sys(k_read, v[0], DATA, v[1], 0);
+	case 3:
+		if(P(v[1]) > MAXIO)
+			fault("write too big", v[1]);
+		return sys(k_write, v[0], DATA, v[1], 0);
+	case 4:
+		return sys(k_seek, v[0], v[1], v[2], 0);
+	case 5:
+		return sys(k_close, v[0], 0, 0, 0);
+	case 6:
+		return sys(k_link, 0, PATH1, PATH2, 0);
+	case 7:
+		return sys(k_unlink, 0, PATH1, 0, 0);
+	case 8:
+		return sys(k_mknod, 0, PATH1, v[1], v[2]);
+	case 9:
+		return sys(k_chmod, 0, PATH1, v[1], 0);
+	case 10:
+		if((e = sys(k_mknod, 0, PATH1, 040777, 0)) != 0)
+			return e;
+		snprintf(buf, sizeof buf, "%s/.", av[0]);
+		setpath(PATH2, buf);
+		if((e = sys(k_link, 0, PATH1, PATH2, 0)) != 0)
+			return e;
+		setpath(PATH1, parent(av[0], buf));
+		snprintf(buf, sizeof buf, "%s/..", av[0]);
+		setpath(PATH2, buf);
+		return sys(k_link, 0, PATH1, PATH2, 0);
+	case 11:
+		snprintf(buf, sizeof buf, "%s/.", av[0]);
+		setpath(PATH1, buf);
+		sys(k_unlink, 0, PATH1, 0, 0);
+		snprintf(buf, sizeof buf, "%s/..", av[0]);
+		setpath(PATH1, buf);
+		sys(k_unlink, 0, PATH1, 0, 0);
+		setpath(PATH1, av[0]);
+		return sys(k_unlink, 0, PATH1, 0, 0);
+	case 12:
+		return sys(k_chdir, 0, PATH1, 0, 0);
+	case 13:
+		return sys(k_stat, 0, PATH1, STATB, 0);
+	case 14:
+		return sys(k_fstat, v[0], STATB, 0, 0);
+	case 15:
+		return sys(k_sync, 0, 0, 0, 0);
+	}
+	return 0;
+}
+
+void
+add(struct count *a, struct count *b)
+{
+	int i;
+
+	a->n += b->n;
+	a->err += b->err;
+	a->refs += b->refs;
+	a->dtime += b->dtime;
+	a->rd += b->rd;
+	a->wr += b->wr;
+	a->cyls += b->cyls;
+	for(i = 0; i < 8; i++)
+		a->ss[i] += b->ss[i];
+}
+
+/*
+ * One call of the trace.
+ */
+void
+call(struct call *cp, char **av, int ac)
+{
+	struct count c;
+	int v[3], ss[8], i, e;
+	long r;
+
+	if(ac != cp->nargs)
+		fault("wrong number of arguments", ac);
+	for(i = 0; i < ac; i++) {
+		v[i] = strtol(av[i], 0, 0);
+		if(cp->paths & 1<<i)
+			setpath(i? PATH2: PATH1, av[i]);
+	}
+	memset(&c, 0, sizeof c);
+	cur = &c;
+	for(i = 0; i < 8; i++)
+		ss[i] = rw(G_sysstat+2*i);
+	tick();
+	r = nref;
+	e = docall(cp, av, v);
+	tick();
+	c.n = 1;
+	c.refs = nref-r;
+	if(e) {
+		c.err = 1;
+		if(vflag)
+			fprintf(stderr, "%s:%d: %s: error %d\n",
+			    tname, tline, cp->name, e);
+	}
+	for(i = 0; i < 8; i++)
+		c.ss[i] = (rw(G_sysstat+2*i) - ss[i]) & 0177777;
+	add(&cp->c, &c);
+}
+
+void
+replay(FILE *f, int every)
+{
+	char line[1000], *av[10], *p;
+	struct call *cp;
+	int ac, n;
+
+	n = 0;
+	tline = 0;
+	while(fgets(line, sizeof line, f)) {
+		tline++;
+		if((p = strchr(line, '#')) != 0)
+			*p = 0;
+		ac = 0;
+		for(p = strtok(line, " \t\n"); p && ac < 10; p = strtok(0, " \t\n"))
+			av[ac++] = p;
+		if(ac == 0)
+			continue;
+		for(cp = calls; cp->name; cp++)
+			if(strcmp(cp->name, av[0]) == 0)
+				break;
+		if(cp->name == 0) {
+			fprintf(stderr, "%s:%d: unknown call %s\n", tname, tline, av[0]);
+			exit(1);
+		}
+		call(cp, av+1, ac-1);
+		if(every && ++n % every == 0)
+			call(&calls[15], 0, 0);
+	}
+}
+
+void
+prcount(char *name, struct count *c)
+{
+	printf("%-7s%7ld%5ld%9.1f%9.1f%7ld%7ld%8ld%5.0f%%%7ld%5.0f%%%7ld%8ld\n",
+	    name, c->n, c->err,
+	    c->refs*usref/1000, c->dtime/1000,
+	    c->rd, c->wr,
+	    c->ss[0], c->ss[0]? 100.0*c->ss[1]/c->ss[0]: 0.0,
+	    c->ss[4], c->ss[4]? 100.0*c->ss[5]/c->ss[4]: 0.0,
+	    c->ss[6], c->ss[7]);
+}
+
+void
+report(void)
+{
+	struct call *cp;
+
+	printf("%-7s%7s%5s%9s%9s%7s%7s%8s%6s%7s%6s%7s%8s\n",
+	    "call", "count", "err", "cpu ms", "disk ms", "reads", "writes",
+	    "bread", "hit", "iget", "hit", "dirs", "entries");
+	for(cp = calls; cp->name; cp++)
+		if(cp->c.n) {
+			prcount(cp->name, &cp->c);
+			add(&total, &cp->c);
+		}
+	prcount("total", &total);
+	printf("disk: %ld transfers, %ld cylinders crossed (%.1f a transfer), "
+	    "%.1f ms busy\n", total.rd+total.wr, total.cyls,
+	    total.rd+total.wr? (double)total.cyls/(total.rd+total.wr): 0.0,
+	    total.dtime/1000);
+	printf("time: %.1f ms simulated at %.2f us a reference\n",
+	    (now-start)/1000, usref);
+}
+
+int
+main(int argc, char **argv)
+{
+	char *iname;
+	FILE *f;
+	int every, i, n;
+
+	iname = 0;
+	every = 0;
+	n = 0;
+	while(argc > 1 && argv[1][0] == '-') {
+		switch(argv[1][1]) {
+		case 'd':
+			for(dk = disks; dk->name; dk++)
+				if(strncmp(dk->name, argv[2], 2) == 0)
+					break;
+			if(dk->name == 0) {
+				fprintf(stderr, "sim: no disk %s\n", argv[2]);
+				exit(1);
+			}
+			break;
+		case 'n':
+			n = atoi(argv[2]);
+			break;
+		case 'i':
+			iname = argv[2];
+			break;
+		case 'c':
+			usref = atof(argv[2]);
+			break;
+		case 's':
+			every = atoi(argv[2]);
+			break;
+		case 'v':
+			vflag++;
+			argc++;
+			argv--;
+			break;
+		default:
+			fprintf(stderr, "sim: unknown flag %s\n", argv[1]);
+			exit(1);
+		}
+		argc -= 2;
+		argv += 2;
+	}
+	nblock = dk->ncyl * dk->ntrk * dk->nsec;
+	if(n > 0 && n < nblock)
+		nblock = n;
+	if(nblock > 65535)
+		nblock = 65535;
+	image = malloc((long)nblock*512);
+	if(image == 0) {
+		fprintf(stderr, "sim: no memory\n");
+		exit(1);
+	}
+	f = iname? fopen(iname, "r"): 0;
+	if(f) {
+		if(fread(image, 512, nblock, f) != nblock) {
+			fprintf(stderr, "sim: %s: short\n", iname);
+			exit(1);
+		}
+		fclose(f);
+	} else
+		mkfs();
+	boot();
+	/* 0, 1 and 2, as a process has them */
+	setpath(PATH1, "/");
+	for(i = 0; i < 3; i++)
+		sys(k_open, 0, PATH1, 0, 0);
+	tick();
+	start = now;
+	for(i = 1; i < argc; i++) {
+		tname = argv[i];
+		f = strcmp(argv[i], "-") == 0? stdin: fopen(argv[i], "r");
+		if(f == 0) {
+			fprintf(stderr, "sim: can't open %s\n", argv[i]);
+			exit(1);
+		}
+		replay(f, every);
+		if(f != stdin)
+			fclose(f);
+	}
+	tname = 0;
+	/* what is still in the buffers */
+	call(&calls[15], 0, 0);
+	report();
+	if(iname) {
+		f = fopen(iname, "w");
+		if(f == 0 || fwrite(image, 512, nblock, f) != nblock) {
+			fprintf(stderr, "sim: can't write %s\n", iname);
+			exit(1);
+		}
+		fclose(f);
+	}
+	return 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * Run time of the kernel as made by tran:
+ * the memory of the simulated 11, loads
+ * and stores through it, and the frames
+ * on its stack.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define	UBASE	((DATAEND+0777)&~0777)	/* user space of the calls, to STKLIM */
+#define	STKLIM	0140000		/* the kernel stack, down from 0160000 */
+#define	STKTOP	0160000
+#define	LOWMEM	0400		/* below: nothing but null pointers */
+
+extern	unsigned char mem[];
+extern	int ksp;
+extern	long nref;
+extern	int (*ftab[])();
+extern	int nftab;
+void	fault(char *, int);
+void	k_init(void);
+
+#define	I(x)	((int)(short)(x))
+#define	P(x)	((int)(unsigned short)(x))
+
+static inline int
+LW(int a)
+{
+	a = P(a);
+	if(a & 1)
+		fault("odd address", a);
+	if(a < LOWMEM)
+		fault("null pointer", a);
+	nref++;
+	return I(mem[a] | mem[a+1]<<8);
+}
+
+static inline int
+LP(int a)
+{
+	return P(LW(a));
+}
+
+static inline int
+LB(int a)
+{
+	a = P(a);
+	if(a < LOWMEM)
+		fault("null pointer", a);
+	nref++;
+	return (signed char)mem[a];
+}
+
+static inline int
+SW(int a, int v)
+{
+	a = P(a);
+	if(a & 1)
+		fault("odd address", a);
+	if(a < LOWMEM)
+		fault("null pointer", a);
+	nref++;
+	mem[a] = v;
+	mem[a+1] = v>>8;
+	return I(v);
+}
+
+static inline int
+SP(int a, int v)
+{
+	return P(SW(a, v));
+}
+
+static inline int
+SB(int a, int v)
+{
+	a = P(a);
+	if(a < LOWMEM)
+		fault("null pointer", a);
+	nref++;
+	mem[a] = v;
+	return (signed char)v;
+}
+
+static inline int
+FRAME(int n)
+{
+	ksp -= n;
+	if(ksp < STKLIM)
+		fault("kernel stack overflow", ksp);
+	return ksp;
+}
+
+#define	UNFRAME(n)	(ksp += (n))
+
+static inline int
+CALLF(int f, int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7)
+{
+	if(f <= 0 || f >= nftab)
+		fault("call through a bad pointer", f);
+	return (*ftab[f])(a0, a1, a2, a3, a4, a5, a6, a7);
+}
@@ -0,0 +1,2306 @@
+/*
+ * tran - translate V6 C into host C
+ * for the file system simulator.
+ *
+ *	tran [-Dname=value] ... out file.c ...
+ *
+ * All the files make one program, as
+ * they would on the loader's command line.
+ * Every object lives in the 64K byte
+ * array mem[] (see sim.h), and every value
+ * is 16 bits: ints and chars are signed,
+ * pointers are not; so the kernel's
+ * pointers in ints, its untyped -> and its
+ * words on the disk mean what they mean
+ * on the 11.  Each function becomes
+ * int k_name(a0, ... a7) with its frame
+ * on a stack in mem[]; out.c gets the code,
+ * out.h the addresses of the globals (G_),
+ * functions (F_), string constants (S_)
+ * and members (M_) for the simulator.
+ *
+ * The preprocessor knows only #include "..."
+ * and #define of a name; -D settles a name
+ * ahead of the files' own #defines.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdarg.h>
+
+#define	NARG	8		/* words of arguments */
+#define	BASE	0400		/* first address of the data */
+
+/*
+ * tokens
+ */
+enum { K_EOF, K_NAME, K_CON, K_STR, K_OP };
+
+struct tok {
+	int	k;
+	char	*s;		/* name, operator or string bytes */
+	int	v;		/* constant value, string length */
+	char	*file;
+	int	line;
+};
+
+struct tok *toks;
+int	ntok, maxtok, tp;
+
+/*
+ * macros
+ */
+struct mac {
+	char	*name;
+	char	*body;
+	int	fixed;		/* from -D */
+	int	busy;
+	struct mac *next;
+} *macs;
+
+/* numeric macros, for the simulator */
+struct mac *nums, **lnum = &nums;
+
+/*
+ * types
+ */
+enum { T_INT, T_CHAR, T_FLOAT, T_DOUBLE, T_PTR, T_ARRAY, T_STRUCT, T_FUNC };
+
+struct type {
+	int	k;
+	struct type *sub;
+	int	n;		/* array length, -1 if not given */
+	struct stag *st;
+};
+
+struct memb {
+	char	*name;
+	int	off;
+	struct type *t;
+	struct memb *next;
+};
+
+struct stag {
+	char	*name;		/* 0 if none */
+	int	size;
+	int	defined;
+	struct memb *mem;
+	struct stag *next;
+} *stags;
+
+/* members by name over all the structures */
+struct gmemb {
+	char	*name;
+	int	off;
+	struct type *t;
+	int	ambig;
+	struct gmemb *next;
+} *gmembs;
+
+struct type tint = { T_INT }, tchar = { T_CHAR };
+
+/*
+ * symbols
+ */
+enum { S_GLOBAL, S_LOCAL, S_FUNC };
+
+struct init {
+	int	off;
+	struct type *t;
+	struct node *e;
+	struct init *next;
+};
+
+struct sym {
+	char	*name;
+	char	*cname;		/* name in the output */
+	int	cls;
+	struct type *t;
+	int	off;		/* frame offset of a local */
+	int	defined;	/* global: storage; function: body */
+	int	fid;		/* function number, 0 if none */
+	int	addr;
+	struct init *init, **linit;
+	struct sym *next;	/* hash chain or scope */
+	struct sym *gnext;	/* globals in order */
+} *ghash[512], *gfirst, **glast = &gfirst, *locals;
+
+int	nfid;
+struct sym *fids[2000];
+
+/*
+ * string constants
+ */
+struct str {
+	char	*s;
+	int	n;
+	int	addr;
+} strs[5000];
+int	nstr;
+
+/*
+ * expression trees
+ */
+enum {
+	N_CON, N_STR, N_GADDR, N_LADDR, N_FUNC, N_IND, N_OFF,
+	N_BIN, N_UN, N_AND, N_OR, N_NOT, N_COND, N_COMMA,
+	N_ASN, N_ASOP, N_INC, N_CALL
+};
+
+struct node {
+	int	op;
+	struct type *t;
+	struct node *l, *r, *x;
+	int	v;		/* constant, offset, delta */
+	int	post;
+	char	*o;		/* operator */
+	struct sym *s;
+	struct node *args[NARG];
+	int	nargs;
+};
+
+char	*curfile;
+int	curline;
+int	errs;
+int	ntemp;
+int	nstatic;
+int	fsize;			/* frame of the current function */
+struct type *rtype;		/* its return type */
+char	*lastparams[NARG];
+int	nlastparams;
+
+FILE	*fc;			/* out.c */
+char	*obuf;			/* body of the current function */
+int	olen, omax;
+
+void	*xalloc(int);
+char	*sf(char *, ...);
+void	error(char *, ...);
+struct node *expr(void);
+struct node *asgn(void);
+struct node *cast(void);
+struct type *declarator(struct type *, char **);
+void	stmt(int);
+
+void *
+xalloc(int n)
+{
+	void *p;
+
+	p = calloc(1, n);
+	if(p == 0) {
+		fprintf(stderr, "tran: out of memory\n");
+		exit(1);
+	}
+	return p;
+}
+
+char *
+sf(char *f, ...)
+{
+	va_list ap;
+	char *s;
+	int n;
+
+	va_start(ap, f);
+	n = vsnprintf(0, 0, f, ap);
+	va_end(ap);
+	s = xalloc(n+1);
+	va_start(ap, f);
+	vsnprintf(s, n+1, f, ap);
+	va_end(ap);
+	return s;
+}
+
+void
+error(char *f, ...)
+{
+	va_list ap;
+
+	if(tp < ntok)
+		fprintf(stderr, "%s:%d: ", toks[tp].file, toks[tp].line);
+	else
+		fprintf(stderr, "%s:%d: ", curfile, curline);
+	va_start(ap, f);
+	vfprintf(stderr, f, ap);
+	va_end(ap);
+	fprintf(stderr, "\n");
+	if(++errs > 20)
+		exit(1);
+}
+
+void
+fatal(char *f, char *s)
+{
+	error(f, s);
+	exit(1);
+}
+
+/*
+ * Output of a function body.
+ */
+void
+emit(char *f, ...)
+{
+	va_list ap;
+	int n;
+
+	va_start(ap, f);
+	n = vsnprintf(0, 0, f, ap);
+	va_end(ap);
+	if(olen+n+1 > omax) {
+		omax = 2*(olen+n+1);
+		obuf = realloc(obuf, omax);
+	}
+	va_start(ap, f);
+	vsnprintf(obuf+olen, n+1, f, ap);
+	va_end(ap);
+	olen += n;
+}
+
+/*
+ * The lexer and preprocessor.
+ */
+char *
+readfile(char *name)
+{
+	FILE *f;
+	char *b;
+	long n;
+
+	f = fopen(name, "r");
+	if(f == 0)
+		return 0;
+	fseek(f, 0L, 2);
+	n = ftell(f);
+	fseek(f, 0L, 0);
+	b = xalloc(n+1);
+	n = fread(b, 1, n, f);
+	b[n] = 0;
+	fclose(f);
+	return b;
+}
+
+struct mac *
+lookmac(char *s)
+{
+	struct mac *m;
+
+	for(m = macs; m; m = m->next)
+		if(strcmp(m->name, s) == 0)
+			return m;
+	return 0;
+}
+
+void
+define(char *name, char *body, int fixed)
+{
+	struct mac *m;
+
+	m = lookmac(name);
+	if(m == 0) {
+		m = xalloc(sizeof *m);
+		m->name = strdup(name);
+		m->next = macs;
+		macs = m;
+	} else if(m->fixed)
+		return;
+	m->body = strdup(body);
+	m->fixed = fixed;
+	if(strspn(body, " \t0123456789()-") == strlen(body) &&
+	    strpbrk(body, "0123456789")) {
+		for(m = nums; m; m = m->next)
+			if(strcmp(m->name, name) == 0)
+				return;
+		m = xalloc(sizeof *m);
+		m->name = strdup(name);
+		m->body = strdup(body);
+		*lnum = m;
+		lnum = &m->next;
+	}
+}
+
+void
+addtok(int k, char *s, int v)
+{
+	struct tok *t;
+
+	if(ntok >= maxtok) {
+		maxtok = maxtok? 2*maxtok: 4096;
+		toks = realloc(toks, maxtok*sizeof *toks);
+	}
+	t = &toks[ntok++];
+	t->k = k;
+	t->s = s;
+	t->v = v;
+	t->file = curfile;
+	t->line = curline;
+}
+
+/* longest first */
+char *ops[] = {
+	"=>>", "=<<",
+	"->", "++", "--", "<<", ">>", "<=", ">=", "==", "!=", "&&", "||",
+	"=+", "=-", "=*", "=/", "=%", "=&", "=^", "=|",
+	0
+};
+
+int
+escape(char **pp)
+{
+	char *p;
+	int c, n;
+
+	p = *pp;
+	c = *p++;
+	if(c != '\\') {
+		*pp = p;
+		return c;
+	}
+	c = *p++;
+	switch(c) {
+	case 'n': c = '\n'; break;
+	case 't': c = '\t'; break;
+	case 'b': c = '\b'; break;
+	case 'r': c = '\r'; break;
+	case 'f': c = '\f'; break;
+	default:
+		if(c >= '0' && c <= '7') {
+			n = c-'0';
+			if(*p >= '0' && *p <= '7')
+				n = n*8 + *p++ - '0';
+			if(*p >= '0' && *p <= '7')
+				n = n*8 + *p++ - '0';
+			c = n;
+		}
+	}
+	*pp = p;
+	return c & 0377;
+}
+
+void lex(char *, char *, int);
+
+void
+directive(char *p, char *file)
+{
+	char name[200], *q, *b, *path;
+	int n;
+
+	while(*p == ' ' || *p == '\t')
+		p++;
+	if(strncmp(p, "include", 7) == 0) {
+		q = strchr(p, '"');
+		if(q == 0)
+			fatal("bad #include", 0);
+		q++;
+		n = strchr(q, '"') - q;
+		memcpy(name, q, n);
+		name[n] = 0;
+		if(name[0] == '/')
+			path = strdup(name);
+		else {
+			q = strrchr(file, '/');
+			n = q? q-file+1: 0;
+			path = sf("%.*s%s", n, file, name);
+		}
+		b = readfile(path);
+		if(b == 0)
+			fatal("can't find %s", path);
+		lex(b, path, 0);
+		return;
+	}
+	if(strncmp(p, "define", 6) == 0) {
+		p += 6;
+		while(*p == ' ' || *p == '\t')
+			p++;
+		q = p;
+		while(isalnum(*p) || *p == '_')
+			p++;
+		n = p-q;
+		memcpy(name, q, n);
+		name[n] = 0;
+		define(name, p, 0);
+		return;
+	}
+	fatal("unknown directive #%s", p);
+}
+
+/*
+ * Tokens of s, from file; macro
+ * bodies come back here with depth > 0.
+ */
+void
+lex(char *s, char *file, int depth)
+{
+	char *p, *q, *b, line[1000];
+	char *ofile;
+	int oline, c, n, bol, i;
+	struct mac *m;
+
+	ofile = curfile;
+	oline = curline;
+	if(depth == 0) {
+		curfile = file;
+		curline = 1;
+	}
+	p = s;
+	bol = 1;
+	for(;;) {
+		c = *p;
+		if(c == 0)
+			break;
+		if(c == '\n') {
+			if(depth == 0)
+				curline++;
+			bol = 1;
+			p++;
+			continue;
+		}
+		if(c == ' ' || c == '\t' || c == '\f' || c == '\r') {
+			p++;
+			continue;
+		}
+		if(c == '#' && bol && depth == 0) {
+			q = strchr(p, '\n');
+			if(q == 0)
+				q = p+strlen(p);
+			/* comments to the end of the line */
+			n = q-p-1;
+			if(n >= sizeof line)
+				n = sizeof line - 1;
+			memcpy(line, p+1, n);
+			line[n] = 0;
+			if((b = strstr(line, "/*")) != 0)
+				*b = 0;
+			if((b = strstr(line, "//")) != 0)
+				*b = 0;
+			for(b = line; *b == ' ' || *b == '\t'; b++)
+				;
+			if(*b)
+				directive(b, file);
+			p = q;
+			continue;
+		}
+		bol = 0;
+		if(c == '/' && p[1] == '*') {
+			for(p += 2; *p && !(p[0] == '*' && p[1] == '/'); p++)
+				if(*p == '\n' && depth == 0)
+					curline++;
+			if(*p)
+				p += 2;
+			continue;
+		}
+		if(c == '/' && p[1] == '/') {
+			while(*p && *p != '\n')
+				p++;
+			continue;
+		}
+		if(isalpha(c) || c == '_') {
+			q = p;
+			while(isalnum(*p) || *p == '_')
+				p++;
+			b = strndup(q, p-q);
+			m = lookmac(b);
+			if(m && !m->busy && depth < 20) {
+				m->busy = 1;
+				lex(m->body, file, depth+1);
+				m->busy = 0;
+				continue;
+			}
+			addtok(K_NAME, b, 0);
+			continue;
+		}
+		if(isdigit(c)) {
+			n = 0;
+			if(c == '0') {
+				while(isdigit(*p))
+					n = n*8 + *p++ - '0';
+			} else {
+				while(isdigit(*p))
+					n = n*10 + *p++ - '0';
+			}
+			if(*p == 'l' || *p == 'L')
+				p++;
+			addtok(K_CON, 0, (short)n);
+			continue;
+		}
+		if(c == '\'') {
+			p++;
+			n = 0;
+			i = 0;
+			while(*p && *p != '\'') {
+				c = escape(&p);
+				n |= c << 8*i++;
+			}
+			p++;
+			if(i == 1 && (n & 0200))
+				n |= ~0377;	/* chars sign extend */
+			addtok(K_CON, 0, (short)n);
+			continue;
+		}
+		if(c == '"') {
+			p++;
+			b = xalloc(strlen(p)+1);
+			n = 0;
+			while(*p && *p != '"') {
+				if(*p == '\\' && p[1] == '\n') {
+					p += 2;
+					continue;
+				}
+				b[n++] = escape(&p);
+			}
+			p++;
+			addtok(K_STR, b, n);
+			continue;
+		}
+		for(i = 0; ops[i]; i++)
+			if(strncmp(p, ops[i], strlen(ops[i])) == 0)
+				break;
+		if(ops[i]) {
+			q = ops[i];
+			p += strlen(q);
+			if(q[0] == '=')		/* =+ is += */
+				q = sf("%s=", q+1);
+			addtok(K_OP, q, 0);
+			continue;
+		}
+		addtok(K_OP, strndup(p, 1), 0);
+		p++;
+	}
+	if(depth == 0) {
+		curfile = ofile;
+		curline = oline;
+	}
+}
+
+/*
+ * Parsing aids.
+ */
+struct tok *
+peek(void)
+{
+	return &toks[tp];
+}
+
+int
+isop(char *s)
+{
+	return toks[tp].k == K_OP && strcmp(toks[tp].s, s) == 0;
+}
+
+int
+isname(char *s)
+{
+	return toks[tp].k == K_NAME && strcmp(toks[tp].s, s) == 0;
+}
+
+void
+expect(char *s)
+{
+	if(!isop(s)) {
+		error("expected %s", s);
+		/* skip on to it */
+		while(tp < ntok-1 && !isop(s) && !isop(";") && !isop("}"))
+			tp++;
+		if(isop(s))
+			tp++;
+		return;
+	}
+	tp++;
+}
+
+/*
+ * Types.
+ */
+struct type *
+mktype(int k, struct type *sub)
+{
+	struct type *t;
+
+	t = xalloc(sizeof *t);
+	t->k = k;
+	t->sub = sub;
+	t->n = -1;
+	return t;
+}
+
+struct type *
+ptrto(struct type *t)
+{
+	return mktype(T_PTR, t);
+}
+
+int
+tsize(struct type *t)
+{
+	switch(t->k) {
+	case T_CHAR:
+		return 1;
+	case T_INT:
+	case T_PTR:
+		return 2;
+	case T_FLOAT:
+		return 4;
+	case T_DOUBLE:
+		return 8;
+	case T_ARRAY:
+		return (t->n < 0? 0: t->n) * tsize(t->sub);
+	case T_STRUCT:
+		if(!t->st->defined)
+			error("size of undefined structure %s", t->st->name);
+		return t->st->size;
+	}
+	return 2;
+}
+
+int
+talign(struct type *t)
+{
+	while(t->k == T_ARRAY)
+		t = t->sub;
+	return t->k == T_CHAR? 1: 2;
+}
+
+int
+isptr(struct type *t)
+{
+	return t->k == T_PTR;
+}
+
+/* scale for pointer arithmetic */
+int
+scale(struct type *t)
+{
+	int n;
+
+	if(t->k != T_PTR)
+		return 1;
+	if(t->sub->k == T_STRUCT && !t->sub->st->defined)
+		return 1;
+	n = tsize(t->sub);
+	return n? n: 1;
+}
+
+struct stag *
+findtag(char *name)
+{
+	struct stag *s;
+
+	for(s = stags; s; s = s->next)
+		if(s->name && strcmp(s->name, name) == 0)
+			return s;
+	s = xalloc(sizeof *s);
+	s->name = strdup(name);
+	s->next = stags;
+	stags = s;
+	return s;
+}
+
+void
+addgmemb(char *name, int off, struct type *t)
+{
+	struct gmemb *g;
+
+	for(g = gmembs; g; g = g->next)
+		if(strcmp(g->name, name) == 0) {
+			if(g->off != off || g->t->k != t->k)
+				g->ambig = 1;
+			return;
+		}
+	g = xalloc(sizeof *g);
+	g->name = name;
+	g->off = off;
+	g->t = t;
+	g->next = gmembs;
+	gmembs = g;
+}
+
+int
+isdecl(void)
+{
+	static char *kw[] = {
+		"int", "char", "float", "double", "struct", "register",
+		"auto", "static", "extern", "unsigned", "long", 0
+	};
+	int i;
+
+	if(peek()->k != K_NAME)
+		return 0;
+	for(i = 0; kw[i]; i++)
+		if(isname(kw[i]))
+			return 1;
+	return 0;
+}
+
+/*
+ * Parse a storage class and base type;
+ * cls gets "extern", "static", "register",
+ * "auto" or 0.
+ */
+struct type *
+basetype(char **cls)
+{
+	struct type *t;
+	struct stag *st;
+	struct memb *m, **lm;
+	struct type *bt, *mt;
+	char *name;
+	int off, sz;
+
+	*cls = 0;
+	t = 0;
+	for(;;) {
+		if(isname("extern") || isname("static") || isname("register") ||
+		    isname("auto")) {
+			*cls = peek()->s;
+			tp++;
+			continue;
+		}
+		if(isname("int") || isname("unsigned") || isname("long")) {
+			tp++;
+			t = &tint;
+			continue;
+		}
+		if(isname("char")) {
+			tp++;
+			t = &tchar;
+			continue;
+		}
+		if(isname("float")) {
+			tp++;
+			t = mktype(T_FLOAT, 0);
+			continue;
+		}
+		if(isname("double")) {
+			tp++;
+			t = mktype(T_DOUBLE, 0);
+			continue;
+		}
+		if(isname("struct")) {
+			tp++;
+			st = 0;
+			if(peek()->k == K_NAME) {
+				st = findtag(peek()->s);
+				tp++;
+			}
+			if(isop("{")) {
+				tp++;
+				if(st == 0) {
+					st = xalloc(sizeof *st);
+					st->next = stags;
+					stags = st;
+				}
+				st->mem = 0;
+				lm = &st->mem;
+				off = 0;
+				while(!isop("}") && peek()->k != K_EOF) {
+					bt = basetype(&name);
+					if(isop(";")) {
+						tp++;
+						continue;
+					}
+					for(;;) {
+						name = 0;
+						mt = declarator(bt, &name);
+						sz = talign(mt);
+						off = (off+sz-1) & ~(sz-1);
+						m = xalloc(sizeof *m);
+						m->name = name;
+						m->off = off;
+						m->t = mt;
+						*lm = m;
+						lm = &m->next;
+						addgmemb(name, off, mt);
+						off += tsize(mt);
+						if(!isop(","))
+							break;
+						tp++;
+					}
+					expect(";");
+				}
+				expect("}");
+				st->size = (off+1) & ~1;
+				st->defined = 1;
+			}
+			t = mktype(T_STRUCT, 0);
+			t->st = st;
+			continue;
+		}
+		break;
+	}
+	return t? t: &tint;
+}
+
+/*
+ * Constant expressions for sizes and cases.
+ */
+int
+constval(struct node *n, int *v)
+{
+	if(n->op == N_CON) {
+		*v = n->v;
+		return 1;
+	}
+	return 0;
+}
+
+struct node *condexpr(void);
+
+int
+cexpr(void)
+{
+	struct node *n;
+	int v;
+
+	n = condexpr();
+	if(!constval(n, &v)) {
+		error("constant expected");
+		return 0;
+	}
+	return v;
+}
+
+/*
+ * Declarators: stars bind to the base,
+ * then the suffixes, then whatever is
+ * inside the parentheses.
+ */
+struct type *
+declarator(struct type *t, char **np)
+{
+	int save, end, depth, i, nsuf, n;
+	int suf[10], sufn[10];
+
+	while(isop("*")) {
+		tp++;
+		t = ptrto(t);
+	}
+	save = -1;
+	if(isop("(")) {
+		save = ++tp;
+		for(depth = 1; depth > 0; tp++) {
+			if(isop("("))
+				depth++;
+			if(isop(")"))
+				depth--;
+		}
+	} else if(peek()->k == K_NAME) {
+		*np = peek()->s;
+		tp++;
+	}
+	nsuf = 0;
+	for(;;) {
+		if(isop("[")) {
+			tp++;
+			n = -1;
+			if(!isop("]"))
+				n = cexpr();
+			expect("]");
+			suf[nsuf] = T_ARRAY;
+			sufn[nsuf++] = n;
+			continue;
+		}
+		if(isop("(")) {
+			tp++;
+			nlastparams = 0;
+			while(peek()->k == K_NAME) {
+				if(nlastparams < NARG)
+					lastparams[nlastparams++] = peek()->s;
+				else
+					error("too many parameters");
+				tp++;
+				if(!isop(","))
+					break;
+				tp++;
+			}
+			expect(")");
+			suf[nsuf] = T_FUNC;
+			sufn[nsuf++] = 0;
+			continue;
+		}
+		break;
+	}
+	for(i = nsuf-1; i >= 0; i--) {
+		t = mktype(suf[i], t);
+		t->n = sufn[i];
+	}
+	if(save >= 0) {
+		end = tp;
+		tp = save;
+		t = declarator(t, np);
+		tp = end;
+	}
+	return t;
+}
+
+/*
+ * Symbols.
+ */
+unsigned
+hash(char *s)
+{
+	unsigned h;
+
+	h = 0;
+	while(*s)
+		h = h*31 + *s++;
+	return h % 512;
+}
+
+struct sym *
+lookglobal(char *name)
+{
+	struct sym *s;
+
+	for(s = ghash[hash(name)]; s; s = s->next)
+		if(strcmp(s->name, name) == 0)
+			return s;
+	return 0;
+}
+
+struct sym *
+global(char *name, char *cname)
+{
+	struct sym *s;
+	int h;
+
+	s = lookglobal(cname);
+	if(s)
+		return s;
+	s = xalloc(sizeof *s);
+	s->name = cname;
+	s->cname = cname;
+	s->linit = &s->init;
+	h = hash(cname);
+	s->next = ghash[h];
+	ghash[h] = s;
+	*glast = s;
+	glast = &s->gnext;
+	return s;
+}
+
+struct sym *
+look(char *name)
+{
+	struct sym *s;
+
+	for(s = locals; s; s = s->next)
+		if(strcmp(s->name, name) == 0)
+			return s;
+	return lookglobal(name);
+}
+
+int
+fid(struct sym *s)
+{
+	if(s->fid == 0) {
+		s->fid = ++nfid;
+		fids[nfid] = s;
+	}
+	return s->fid;
+}
+
+/*
+ * Declare a global of type t; merge it
+ * with what the other files said.
+ */
+struct sym *
+declglobal(char *name, char *cname, struct type *t, int ext)
+{
+	struct sym *s;
+
+	s = global(name, cname);
+	if(t->k == T_FUNC) {
+		s->cls = S_FUNC;
+		if(s->t == 0)
+			s->t = t;
+		return s;
+	}
+	/* extern f; then &f is the function */
+	if(s->cls == S_FUNC && ext)
+		return s;
+	s->cls = S_GLOBAL;
+	if(s->t == 0 || (s->t->k == T_ARRAY && s->t->n < 0) ||
+	    (s->t->k == T_ARRAY && t->k == T_ARRAY && t->n > s->t->n))
+		s->t = t;
+	if(!ext)
+		s->defined = 1;
+	return s;
+}
+
+/*
+ * Expressions.
+ */
+struct node *
+mknode(int op, struct type *t, struct node *l, struct node *r)
+{
+	struct node *n;
+
+	n = xalloc(sizeof *n);
+	n->op = op;
+	n->t = t;
+	n->l = l;
+	n->r = r;
+	return n;
+}
+
+struct node *
+con(int v)
+{
+	struct node *n;
+
+	n = mknode(N_CON, &tint, 0, 0);
+	n->v = (short)v;
+	return n;
+}
+
+struct node *
+funcval(struct node *n)
+{
+	struct node *r;
+
+	fid(n->s);
+	r = mknode(N_FUNC, ptrto(n->t), 0, 0);
+	r->s = n->s;
+	r->v = 1;		/* the value, not the designator */
+	return r;
+}
+
+struct node *
+val(struct node *n)
+{
+	if(n->op == N_FUNC && n->v == 0)
+		return funcval(n);
+	if(n->op == N_IND && (n->t->k == T_ARRAY || n->t->k == T_STRUCT))
+		return mknode(N_OFF, ptrto(n->t->k == T_ARRAY? n->t->sub: n->t),
+		    n->l, 0);
+	return n;
+}
+
+/* the object at address a */
+struct node *
+ind(struct node *a, struct type *t)
+{
+	return mknode(N_IND, t, a, 0);
+}
+
+struct node *
+offset(struct node *a, int off, struct type *t)
+{
+	struct node *n;
+
+	n = mknode(N_OFF, ptrto(t), a, 0);
+	n->v = off;
+	return ind(n, t);
+}
+
+/* the address of an lvalue */
+struct node *
+addr(struct node *n)
+{
+	if(n->op == N_IND) {
+		if(n->l->op == N_OFF && n->l->v == 0)
+			return mknode(N_OFF, ptrto(n->t), n->l->l, 0);
+		return mknode(N_OFF, ptrto(n->t), n->l, 0);
+	}
+	if(n->op == N_FUNC)
+		return funcval(n);
+	error("not an lvalue");
+	return con(0);
+}
+
+int
+fold(char *o, int a, int b, int *v)
+{
+	int r;
+
+	if(strcmp(o, "+") == 0) r = a+b;
+	else if(strcmp(o, "-") == 0) r = a-b;
+	else if(strcmp(o, "*") == 0) r = a*b;
+	else if(strcmp(o, "/") == 0) { if(b == 0) return 0; r = a/b; }
+	else if(strcmp(o, "%") == 0) { if(b == 0) return 0; r = a%b; }
+	else if(strcmp(o, "<<") == 0) r = a<<b;
+	else if(strcmp(o, ">>") == 0) r = a>>b;
+	else if(strcmp(o, "&") == 0) r = a&b;
+	else if(strcmp(o, "|") == 0) r = a|b;
+	else if(strcmp(o, "^") == 0) r = a^b;
+	else if(strcmp(o, "==") == 0) r = a==b;
+	else if(strcmp(o, "!=") == 0) r = a!=b;
+	else if(strcmp(o, "<") == 0) r = a<b;
+	else if(strcmp(o, ">") == 0) r = a>b;
+	else if(strcmp(o, "<=") == 0) r = a<=b;
+	else if(strcmp(o, ">=") == 0) r = a>=b;
+	else return 0;
+	*v = (short)r;
+	return 1;
+}
+
+int
+isrel(char *o)
+{
+	return strcmp(o, "==") == 0 || strcmp(o, "!=") == 0 ||
+	    strcmp(o, "<") == 0 || strcmp(o, ">") == 0 ||
+	    strcmp(o, "<=") == 0 || strcmp(o, ">=") == 0;
+}
+
+/* a binary operator on values */
+struct node *
+binary(char *o, struct node *l, struct node *r)
+{
+	struct node *n;
+	struct type *t;
+	int v;
+
+	l = val(l);
+	r = val(r);
+	if(l->op == N_CON && r->op == N_CON && fold(o, l->v, r->v, &v))
+		return con(v);
+	t = &tint;
+	if(strcmp(o, "+") == 0) {
+		if(isptr(r->t) && !isptr(l->t)) {
+			n = l;
+			l = r;
+			r = n;
+		}
+		if(isptr(l->t))
+			t = l->t;
+	} else if(strcmp(o, "-") == 0) {
+		if(isptr(l->t) && !isptr(r->t))
+			t = l->t;
+	} else if(isrel(o))
+		t = &tint;
+	n = mknode(N_BIN, t, l, r);
+	n->o = o;
+	return n;
+}
+
+struct node *
+unary(char *o, struct node *l)
+{
+	struct node *n;
+
+	l = val(l);
+	if(l->op == N_CON) {
+		if(strcmp(o, "-") == 0)
+			return con(-l->v);
+		if(strcmp(o, "~") == 0)
+			return con(~l->v);
+		if(strcmp(o, "!") == 0)
+			return con(!l->v);
+	}
+	n = mknode(strcmp(o, "!") == 0? N_NOT: N_UN, &tint, l, 0);
+	n->o = o;
+	return n;
+}
+
+/* member m of the structure at address a */
+struct node *
+member(struct node *a, struct type *st, char *m)
+{
+	struct memb *p;
+	struct gmemb *g;
+
+	if(st && st->k == T_STRUCT && st->st->defined)
+		for(p = st->st->mem; p; p = p->next)
+			if(strcmp(p->name, m) == 0)
+				return offset(a, p->off, p->t);
+	for(g = gmembs; g; g = g->next)
+		if(strcmp(g->name, m) == 0) {
+			if(g->ambig)
+				error("ambiguous member %s", m);
+			return offset(a, g->off, g->t);
+		}
+	error("unknown member %s", m);
+	return ind(a, &tint);
+}
+
+struct node *
+primary(void)
+{
+	struct tok *k;
+	struct node *n;
+	struct sym *s;
+	struct type *t;
+
+	k = peek();
+	if(k->k == K_CON) {
+		tp++;
+		return con(k->v);
+	}
+	if(k->k == K_STR) {
+		tp++;
+		if(nstr >= 5000)
+			fatal("too many strings", 0);
+		strs[nstr].s = k->s;
+		strs[nstr].n = k->v;
+		n = mknode(N_STR, ptrto(&tchar), 0, 0);
+		n->v = nstr++;
+		return n;
+	}
+	if(k->k == K_NAME) {
+		tp++;
+		s = look(k->s);
+		if(s == 0) {
+			if(!isop("(")) {
+				error("%s undefined", k->s);
+				return con(0);
+			}
+			/* implicitly a function */
+			t = mktype(T_FUNC, &tint);
+			s = declglobal(k->s, k->s, t, 1);
+		}
+		if(s->cls == S_FUNC) {
+			n = mknode(N_FUNC, s->t, 0, 0);
+			n->s = s;
+			return n;
+		}
+		if(s->cls == S_LOCAL) {
+			n = mknode(N_LADDR, ptrto(s->t), 0, 0);
+			n->v = s->off;
+			return ind(n, s->t);
+		}
+		n = mknode(N_GADDR, ptrto(s->t), 0, 0);
+		n->s = s;
+		return ind(n, s->t);
+	}
+	if(isop("(")) {
+		tp++;
+		n = expr();
+		expect(")");
+		return n;
+	}
+	error("syntax error at %s", k->s? k->s: "constant");
+	tp++;
+	return con(0);
+}
+
+struct node *
+postfix(void)
+{
+	struct node *n, *a, *c;
+	struct type *t;
+	char *m;
+
+	n = primary();
+	for(;;) {
+		if(isop("[")) {
+			tp++;
+			a = expr();
+			expect("]");
+			a = binary("+", n, a);
+			t = isptr(a->t)? a->t->sub: &tint;
+			n = ind(a, t);
+			continue;
+		}
+		if(isop("(")) {
+			tp++;
+			c = mknode(N_CALL, &tint, 0, 0);
+			if(n->op == N_FUNC) {
+				c->s = n->s;
+				if(n->t->k == T_FUNC)
+					c->t = n->t->sub;
+			} else {
+				/* (*f)(), through a pointer */
+				if(n->op == N_IND && n->t->k == T_FUNC) {
+					c->t = n->t->sub;
+					n = n->l;
+				} else {
+					n = val(n);
+					if(isptr(n->t) && n->t->sub->k == T_FUNC)
+						c->t = n->t->sub->sub;
+				}
+				c->l = n;
+			}
+			while(!isop(")")) {
+				a = val(asgn());
+				if(c->nargs >= NARG)
+					error("too many arguments");
+				else
+					c->args[c->nargs++] = a;
+				if(!isop(","))
+					break;
+				tp++;
+			}
+			expect(")");
+			if(c->t->k == T_ARRAY || c->t->k == T_STRUCT || c->t->k == T_FUNC)
+				c->t = &tint;
+			n = c;
+			continue;
+		}
+		if(isop("->")) {
+			tp++;
+			m = peek()->s;
+			tp++;
+			a = val(n);
+			n = member(a, isptr(a->t)? a->t->sub: 0, m);
+			continue;
+		}
+		if(isop(".")) {
+			tp++;
+			m = peek()->s;
+			tp++;
+			if(n->op != N_IND) {
+				/* 0->m, constants as structures */
+				n = member(val(n), 0, m);
+				continue;
+			}
+			t = n->t;
+			n = member(addr(n), t, m);
+			continue;
+		}
+		if(isop("++") || isop("--")) {
+			a = mknode(N_INC, n->t, n, 0);
+			a->v = (isop("++")? 1: -1) * scale(n->t);
+			a->post = 1;
+			tp++;
+			n = a;
+			continue;
+		}
+		break;
+	}
+	return n;
+}
+
+struct node *
+cast(void)
+{
+	struct node *n;
+	struct type *t;
+	char *cls, *name;
+
+	if(isop("-") || isop("~") || isop("!")) {
+		char *o = peek()->s;
+		tp++;
+		return unary(o, cast());
+	}
+	if(isop("*")) {
+		tp++;
+		n = val(cast());
+		return ind(n, isptr(n->t)? n->t->sub: &tint);
+	}
+	if(isop("&")) {
+		tp++;
+		n = cast();
+		if(n->op == N_IND && n->t->k == T_ARRAY)
+			return val(n);
+		return addr(n);
+	}
+	if(isop("++") || isop("--")) {
+		int d = isop("++")? 1: -1;
+		tp++;
+		n = cast();
+		n = mknode(N_INC, n->t, n, 0);
+		n->v = d * scale(n->l->t);
+		return n;
+	}
+	if(isname("sizeof")) {
+		tp++;
+		if(isop("(") && (tp++, isdecl())) {
+			t = basetype(&cls);
+			name = 0;
+			t = declarator(t, &name);
+			expect(")");
+			return con(tsize(t));
+		}
+		if(toks[tp-1].k == K_OP && strcmp(toks[tp-1].s, "(") == 0)
+			tp--;
+		n = cast();
+		return con(tsize(n->t));
+	}
+	return postfix();
+}
+
+struct node *
+binexpr(int prec)
+{
+	static char *levels[][7] = {
+		{ "||" },
+		{ "&&" },
+		{ "|" },
+		{ "^" },
+		{ "&" },
+		{ "==", "!=" },
+		{ "<", ">", "<=", ">=" },
+		{ "<<", ">>" },
+		{ "+", "-" },
+		{ "*", "/", "%" },
+	};
+	struct node *l, *r, *n;
+	char *o;
+	int i;
+
+	if(prec >= 10)
+		return cast();
+	l = binexpr(prec+1);
+	for(;;) {
+		o = 0;
+		for(i = 0; i < 7 && levels[prec][i]; i++)
+			if(isop(levels[prec][i]))
+				o = levels[prec][i];
+		if(o == 0)
+			return l;
+		tp++;
+		r = binexpr(prec+1);
+		if(prec == 0 || prec == 1) {
+			n = mknode(prec == 0? N_OR: N_AND, &tint, val(l), val(r));
+			l = n;
+		} else
+			l = binary(o, l, r);
+	}
+}
+
+struct node *
+condexpr(void)
+{
+	struct node *c, *a, *b, *n;
+
+	c = binexpr(0);
+	if(!isop("?"))
+		return c;
+	tp++;
+	a = val(expr());
+	expect(":");
+	b = val(condexpr());
+	n = mknode(N_COND, isptr(a->t)? a->t: b->t, val(c), a);
+	n->x = b;
+	return n;
+}
+
+struct node *
+asgn(void)
+{
+	struct node *l, *n;
+	char *o;
+
+	l = condexpr();
+	if(isop("=")) {
+		tp++;
+		n = mknode(N_ASN, l->t, l, val(asgn()));
+		if(l->op != N_IND)
+			error("not an lvalue");
+		return n;
+	}
+	if(peek()->k == K_OP && strlen(o = peek()->s) >= 2 &&
+	    o[strlen(o)-1] == '=' && strcmp(o, "==") && strcmp(o, "!=") &&
+	    strcmp(o, "<=") && strcmp(o, ">=")) {
+		tp++;
+		n = mknode(N_ASOP, l->t, l, val(asgn()));
+		n->o = strndup(o, strlen(o)-1);
+		if(l->op != N_IND)
+			error("not an lvalue");
+		return n;
+	}
+	return l;
+}
+
+struct node *
+expr(void)
+{
+	struct node *l;
+
+	l = asgn();
+	while(isop(",")) {
+		tp++;
+		l = mknode(N_COMMA, &tint, val(l), 0);
+		l->r = val(asgn());
+		l->t = l->r->t;
+	}
+	return l;
+}
+
+/*
+ * Code generation: a host C expression
+ * for each tree.
+ */
+char *gen(struct node *);
+
+char *
+load(struct type *t, char *a)
+{
+	if(t->k == T_CHAR)
+		return sf("LB(%s)", a);
+	if(t->k == T_PTR)
+		return sf("LP(%s)", a);
+	if(t->k == T_INT)
+		return sf("LW(%s)", a);
+	error("can't load this type");
+	return "0";
+}
+
+char *
+store(struct type *t, char *a, char *v)
+{
+	if(t->k == T_CHAR)
+		return sf("SB(%s, %s)", a, v);
+	if(t->k == T_PTR)
+		return sf("SP(%s, %s)", a, v);
+	if(t->k == T_INT)
+		return sf("SW(%s, %s)", a, v);
+	error("can't store this type");
+	return "0";
+}
+
+/* a op b on values of types lt and rt */
+char *
+arith(char *o, struct type *lt, char *a, struct type *rt, char *b, struct type *t)
+{
+	int s;
+
+	if(strcmp(o, "+") == 0 || strcmp(o, "-") == 0) {
+		if(isptr(lt) && isptr(rt) && *o == '-') {
+			s = scale(lt);
+			if(s == 1)
+				return sf("I(%s - %s)", a, b);
+			return sf("I(I(%s - %s) / %d)", a, b, s);
+		}
+		if(isptr(lt) && !isptr(rt)) {
+			s = scale(lt);
+			if(s != 1)
+				return sf("P(%s %s %s*%d)", a, o, b, s);
+			return sf("P(%s %s %s)", a, o, b);
+		}
+		if(isptr(t))
+			return sf("P(%s %s %s)", a, o, b);
+		return sf("I(%s %s %s)", a, o, b);
+	}
+	if(isrel(o)) {
+		if(isptr(lt) || isptr(rt))
+			return sf("(P(%s) %s P(%s))", a, o, b);
+		return sf("(%s %s %s)", a, o, b);
+	}
+	if(strcmp(o, "/") == 0 || strcmp(o, "%") == 0 || strcmp(o, ">>") == 0) {
+		if(isptr(lt))
+			return sf("I(P(%s) %s %s)", a, o, b);
+		return sf("I(%s %s %s)", a, o, b);
+	}
+	if(strcmp(o, "<<") == 0)
+		return sf("I((unsigned)%s << (%s))", a, b);
+	return sf("I(%s %s %s)", a, o, b);
+}
+
+char *
+gen(struct node *n)
+{
+	char *a, *b, *t;
+	int i;
+
+	switch(n->op) {
+	case N_CON:
+		return sf("%d", n->v);
+	case N_STR:
+		return sf("S_%d", n->v);
+	case N_GADDR:
+		return sf("G_%s", n->s->cname);
+	case N_LADDR:
+		return sf("(_fp+%d)", n->v);
+	case N_FUNC:
+		if(n->v == 0)
+			fid(n->s);
+		return sf("F_%s", n->s->cname);
+	case N_OFF:
+		a = gen(n->l);
+		if(n->v == 0)
+			return a;
+		return sf("P(%s+%d)", a, n->v);
+	case N_IND:
+		if(n->t->k == T_ARRAY || n->t->k == T_STRUCT)
+			return gen(val(n));
+		if(n->t->k == T_FUNC) {
+			error("function used as a value");
+			return "0";
+		}
+		return load(n->t, gen(n->l));
+	case N_BIN:
+		return arith(n->o, n->l->t, gen(n->l), n->r->t, gen(n->r), n->t);
+	case N_UN:
+		return sf("I(%s%s)", n->o, gen(n->l));
+	case N_NOT:
+		return sf("(!%s)", gen(n->l));
+	case N_AND:
+		return sf("(%s && %s)", gen(n->l), gen(n->r));
+	case N_OR:
+		return sf("(%s || %s)", gen(n->l), gen(n->r));
+	case N_COND:
+		return sf("(%s ? %s : %s)", gen(n->l), gen(n->r), gen(n->x));
+	case N_COMMA:
+		return sf("(%s, %s)", gen(n->l), gen(n->r));
+	case N_ASN:
+		return store(n->l->t, gen(n->l->l), gen(n->r));
+	case N_ASOP:
+		i = ++ntemp;
+		a = sf("_a%d", i);
+		b = load(n->l->t, a);
+		t = arith(n->o, n->l->t, b, n->r->t, gen(n->r),
+		    isptr(n->l->t)? n->l->t: &tint);
+		return sf("({ int %s = %s; %s; })", a, gen(n->l->l),
+		    store(n->l->t, a, t));
+	case N_INC:
+		if(n->l->op != N_IND) {
+			error("not an lvalue");
+			return "0";
+		}
+		i = ++ntemp;
+		a = sf("_a%d", i);
+		b = sf("_v%d", i);
+		t = store(n->l->t, a, sf("%s + %d", b, n->v));
+		if(n->post)
+			return sf("({ int %s = %s; int %s = %s; %s; %s; })", a,
+			    gen(n->l->l), b, load(n->l->t, a), t, b);
+		return sf("({ int %s = %s; int %s = %s; %s; })", a,
+		    gen(n->l->l), b, load(n->l->t, a), t);
+	case N_CALL:
+		if(n->s)
+			t = sf("k_%s(", n->s->cname);
+		else
+			t = sf("CALLF(%s, ", gen(n->l));
+		for(i = 0; i < NARG; i++)
+			t = sf("%s%s%s", t, i < n->nargs? gen(n->args[i]): "0",
+			    i < NARG-1? ", ": ")");
+		return t;
+	}
+	error("bad tree");
+	return "0";
+}
+
+/*
+ * Statements.
+ */
+int	nlab;
+
+void
+indent(int d)
+{
+	while(d-- > 0)
+		emit("\t");
+}
+
+void localdecl(int);
+
+void
+block(int d)
+{
+	struct sym *save;
+
+	save = locals;
+	expect("{");
+	while(isdecl())
+		localdecl(d);
+	while(!isop("}") && peek()->k != K_EOF)
+		stmt(d);
+	expect("}");
+	locals = save;
+}
+
+char *
+cond(void)
+{
+	char *s;
+
+	expect("(");
+	s = gen(val(expr()));
+	expect(")");
+	return s;
+}
+
+void
+stmt(int d)
+{
+	struct node *n;
+	char *s;
+	int v;
+
+	if(isop("{")) {
+		indent(d);
+		emit("{\n");
+		block(d+1);
+		indent(d);
+		emit("}\n");
+		return;
+	}
+	if(isop(";")) {
+		tp++;
+		indent(d);
+		emit(";\n");
+		return;
+	}
+	if(peek()->k == K_NAME && toks[tp+1].k == K_OP &&
+	    strcmp(toks[tp+1].s, ":") == 0 && !isname("default")) {
+		indent(d-1);
+		emit("L_%s:\n", peek()->s);
+		tp += 2;
+		if(isop("}")) {
+			indent(d);
+			emit(";\n");
+			return;
+		}
+		stmt(d);
+		return;
+	}
+	if(isname("if")) {
+		tp++;
+		s = cond();
+		indent(d);
+		emit("if (%s) {\n", s);
+		stmt(d+1);
+		indent(d);
+		emit("}");
+		if(isname("else")) {
+			tp++;
+			emit(" else {\n");
+			stmt(d+1);
+			indent(d);
+			emit("}");
+		}
+		emit("\n");
+		return;
+	}
+	if(isname("while")) {
+		tp++;
+		s = cond();
+		indent(d);
+		emit("while (%s) {\n", s);
+		stmt(d+1);
+		indent(d);
+		emit("}\n");
+		return;
+	}
+	if(isname("do")) {
+		tp++;
+		indent(d);
+		emit("do {\n");
+		stmt(d+1);
+		if(!isname("while"))
+			error("expected while");
+		tp++;
+		s = cond();
+		expect(";");
+		indent(d);
+		emit("} while (%s);\n", s);
+		return;
+	}
+	if(isname("for")) {
+		char *a, *b, *c;
+
+		tp++;
+		expect("(");
+		a = isop(";")? "": gen(val(expr()));
+		expect(";");
+		b = isop(";")? "1": gen(val(expr()));
+		expect(";");
+		c = isop(")")? "": gen(val(expr()));
+		expect(")");
+		indent(d);
+		emit("for (%s; %s; %s) {\n", a, b, c);
+		stmt(d+1);
+		indent(d);
+		emit("}\n");
+		return;
+	}
+	if(isname("switch")) {
+		tp++;
+		s = cond();
+		indent(d);
+		emit("switch (%s) {\n", s);
+		stmt(d);
+		indent(d);
+		emit("}\n");
+		return;
+	}
+	if(isname("case")) {
+		tp++;
+		v = cexpr();
+		expect(":");
+		indent(d-1);
+		emit("case %d:\n", v);
+		if(isop("}")) {
+			indent(d);
+			emit(";\n");
+			return;
+		}
+		stmt(d);
+		return;
+	}
+	if(isname("default")) {
+		tp++;
+		expect(":");
+		indent(d-1);
+		emit("default:\n");
+		if(isop("}")) {
+			indent(d);
+			emit(";\n");
+			return;
+		}
+		stmt(d);
+		return;
+	}
+	if(isname("break") || isname("continue")) {
+		indent(d);
+		emit("%s;\n", peek()->s);
+		tp++;
+		expect(";");
+		return;
+	}
+	if(isname("goto")) {
+		tp++;
+		indent(d);
+		emit("goto L_%s;\n", peek()->s);
+		tp++;
+		expect(";");
+		return;
+	}
+	if(isname("return")) {
+		tp++;
+		indent(d);
+		if(isop(";"))
+			emit("goto _ret;\n");
+		else {
+			n = val(expr());
+			s = gen(n);
+			if(rtype->k == T_CHAR)
+				s = sf("(signed char)(%s)", s);
+			emit("{ _r = %s; goto _ret; }\n", s);
+		}
+		expect(";");
+		return;
+	}
+	n = expr();
+	indent(d);
+	emit("%s;\n", gen(val(n)));
+	expect(";");
+}
+
+/*
+ * Initializers: the scalars of t at off,
+ * in order; char arrays take strings.
+ */
+void
+addinit(struct sym *s, int off, struct type *t, struct node *e)
+{
+	struct init *i;
+
+	i = xalloc(sizeof *i);
+	i->off = off;
+	i->t = t;
+	i->e = e;
+	*s->linit = i;
+	s->linit = &i->next;
+}
+
+struct node *nextinit(int *);
+
+/* fill t at off; return 0 when the initializers run out */
+int
+initobj(struct sym *s, int off, struct type *t, int *more)
+{
+	struct memb *m;
+	struct node *e;
+	int i;
+
+	if(t->k == T_ARRAY) {
+		if(t->sub->k == T_CHAR && peek()->k == K_STR) {
+			e = primary();
+			for(i = 0; i <= strs[e->v].n; i++)
+				if(t->n < 0 || i < t->n)
+					addinit(s, off+i, &tchar,
+					    con(i < strs[e->v].n? strs[e->v].s[i]: 0));
+			if(t->n < 0)
+				t->n = strs[e->v].n+1;
+			nstr--;
+			*more = isop(",") && (tp++, !isop("}"));
+			return 1;
+		}
+		for(i = 0; t->n < 0 || i < t->n; i++) {
+			if(!*more)
+				break;
+			initobj(s, off+i*tsize(t->sub), t->sub, more);
+		}
+		if(t->n < 0)
+			t->n = i;
+		return 1;
+	}
+	if(t->k == T_STRUCT) {
+		for(m = t->st->mem; m && *more; m = m->next)
+			initobj(s, off+m->off, m->t, more);
+		return 1;
+	}
+	if(!*more)
+		return 0;
+	e = nextinit(more);
+	addinit(s, off, t, e);
+	return 1;
+}
+
+int	initdepth;
+
+struct node *
+nextinit(int *more)
+{
+	struct node *e;
+
+	while(isop("{")) {
+		tp++;
+		initdepth++;
+	}
+	e = val(asgn());
+	for(;;) {
+		if(isop(",")) {
+			tp++;
+			continue;
+		}
+		if(isop("}") && initdepth > 0) {
+			tp++;
+			initdepth--;
+			continue;
+		}
+		break;
+	}
+	*more = initdepth > 0 && !isop("}");
+	if(initdepth == 0 || isop(";"))
+		*more = 0;
+	return e;
+}
+
+void
+initializer(struct sym *s)
+{
+	int more;
+
+	if(isop("="))
+		tp++;
+	if(isop(",") || isop(";"))
+		return;
+	initdepth = 0;
+	more = 1;
+	if(isop("{")) {
+		tp++;
+		initdepth = 1;
+		if(isop("}"))
+			more = 0;
+	}
+	s->defined = 1;
+	s->init = 0;
+	s->linit = &s->init;
+	initobj(s, 0, s->t, &more);
+	while(initdepth > 0 && isop("}")) {
+		tp++;
+		initdepth--;
+	}
+	while(initdepth > 0 && !isop(";") && peek()->k != K_EOF)
+		tp++;
+}
+
+/*
+ * Declarations in a function.
+ */
+void
+localdecl(int d)
+{
+	struct type *bt, *t;
+	struct sym *s;
+	char *cls, *name;
+	int al;
+
+	bt = basetype(&cls);
+	while(!isop(";")) {
+		name = 0;
+		t = declarator(bt, &name);
+		if(name == 0) {
+			error("declarator expected");
+			break;
+		}
+		if((cls && strcmp(cls, "extern") == 0) || t->k == T_FUNC) {
+			s = declglobal(name, name, t, 1);
+			/* shadow any local of the name */
+			s = xalloc(sizeof *s);
+			*s = *lookglobal(name);
+			s->next = locals;
+			locals = s;
+		} else if(cls && strcmp(cls, "static") == 0) {
+			s = declglobal(name, sf("%s_%d", name, ++nstatic), t, 0);
+			s = xalloc(sizeof *s);
+			*s = *lookglobal(sf("%s_%d", name, nstatic));
+			s->name = name;
+			s->next = locals;
+			locals = s;
+			if(!isop(",") && !isop(";"))
+				initializer(lookglobal(s->cname));
+		} else {
+			s = xalloc(sizeof *s);
+			s->name = name;
+			s->cls = S_LOCAL;
+			s->t = t;
+			al = talign(t);
+			fsize = (fsize+al-1) & ~(al-1);
+			s->off = fsize;
+			fsize += tsize(t);
+			s->next = locals;
+			locals = s;
+		}
+		if(!isop(","))
+			break;
+		tp++;
+	}
+	expect(";");
+}
+
+/*
+ * A function definition, the
+ * declarator already parsed.
+ */
+void
+funcdef(char *name, struct type *t)
+{
+	struct sym *s, *p;
+	char *pn[NARG];
+	struct type *bt, *pt;
+	char *cls, *n;
+	int np, i;
+
+	s = declglobal(name, name, t, 0);
+	s->t = t;
+	if(s->defined)
+		error("%s defined twice", name);
+	s->defined = 1;
+	np = nlastparams;
+	memcpy(pn, lastparams, sizeof pn);
+	locals = 0;
+	fsize = 0;
+	rtype = t->sub;
+	for(i = 0; i < np; i++) {
+		p = xalloc(sizeof *p);
+		p->name = pn[i];
+		p->cls = S_LOCAL;
+		p->t = &tint;
+		p->off = 2*i;
+		p->next = locals;
+		locals = p;
+	}
+	fsize = 2*NARG;
+	/* declarations of the parameters */
+	while(!isop("{") && peek()->k != K_EOF) {
+		bt = basetype(&cls);
+		for(;;) {
+			n = 0;
+			pt = declarator(bt, &n);
+			for(p = locals; p; p = p->next)
+				if(strcmp(p->name, n) == 0)
+					break;
+			if(p == 0)
+				error("%s is not a parameter", n);
+			else {
+				/* an array parameter is a pointer */
+				if(pt->k == T_ARRAY)
+					pt = ptrto(pt->sub);
+				p->t = pt;
+			}
+			if(!isop(","))
+				break;
+			tp++;
+		}
+		expect(";");
+	}
+	olen = 0;
+	emit("");
+	ntemp = 0;
+	block(1);
+	fsize = (fsize+1) & ~1;
+	fprintf(fc, "\nint\nk_%s(", name);
+	for(i = 0; i < NARG; i++)
+		fprintf(fc, "int a%d%s", i, i < NARG-1? ", ": ")\n{\n");
+	fprintf(fc, "\tint _fp, _r;\n\n");
+	fprintf(fc, "\t_r = 0;\n\t_fp = FRAME(%d);\n", fsize);
+	for(i = 0; i < NARG; i++)
+		fprintf(fc, "\tSW(_fp+%d, a%d);\n", 2*i, i);
+	fprintf(fc, "%s", obuf);
+	fprintf(fc, "_ret:\n\tUNFRAME(%d);\n\treturn _r;\n}\n", fsize);
+	locals = 0;
+}
+
+void
+program(void)
+{
+	struct type *bt, *t;
+	struct sym *s;
+	char *cls, *name;
+
+	while(peek()->k != K_EOF) {
+		if(isop(";")) {
+			tp++;
+			continue;
+		}
+		bt = basetype(&cls);
+		if(isop(";")) {
+			tp++;
+			continue;
+		}
+		for(;;) {
+			name = 0;
+			nlastparams = 0;
+			t = declarator(bt, &name);
+			if(name == 0) {
+				error("declarator expected");
+				tp++;
+				break;
+			}
+			if(t->k == T_FUNC && !isop(",") && !isop(";")) {
+				funcdef(name, t);
+				break;
+			}
+			s = declglobal(name, name, t,
+			    cls && strcmp(cls, "extern") == 0);
+			if(t->k != T_FUNC && !isop(",") && !isop(";"))
+				initializer(s);
+			if(!isop(","))  {
+				expect(";");
+				break;
+			}
+			tp++;
+		}
+	}
+}
+
+/*
+ * Lay out the data and write the
+ * tables.
+ */
+int
+main(int argc, char **argv)
+{
+	struct sym *s;
+	struct init *in;
+	struct stag *st;
+	struct memb *m;
+	struct gmemb *g;
+	struct mac *mp;
+	FILE *fh;
+	char *out, *b, *q;
+	int a, i, sz;
+
+	while(argc > 1 && strncmp(argv[1], "-D", 2) == 0) {
+		q = strchr(argv[1], '=');
+		if(q == 0)
+			define(argv[1]+2, "1", 1);
+		else {
+			*q = 0;
+			define(argv[1]+2, q+1, 1);
+		}
+		argc--;
+		argv++;
+	}
+	if(argc < 3) {
+		fprintf(stderr, "usage: tran [-Dx=y] out file.c ...\n");
+		exit(1);
+	}
+	out = argv[1];
+	fc = fopen(sf("%s.c", out), "w");
+	if(fc == 0)
+		fatal("can't create %s.c", out);
+	fprintf(fc, "/* made by tran from V6 C; do not edit */\n");
+	fprintf(fc, "#include \"sim.h\"\n#include \"%s.h\"\n", out);
+	fprintf(fc, "#include \"%s.p\"\n", out);
+	for(i = 2; i < argc; i++) {
+		b = readfile(argv[i]);
+		if(b == 0)
+			fatal("can't open %s", argv[i]);
+		/* each file has its own #defines */
+		{
+			struct mac *m, **lm;
+
+			for(lm = &macs; (m = *lm) != 0; )
+				if(!m->fixed)
+					*lm = m->next;
+				else
+					lm = &m->next;
+		}
+		ntok = 0;
+		lex(b, argv[i], 0);
+		addtok(K_EOF, "end of file", 0);
+		tp = 0;
+		program();
+	}
+	if(errs)
+		exit(1);
+
+	/* data */
+	a = BASE;
+	for(s = gfirst; s; s = s->gnext) {
+		if(s->cls != S_GLOBAL)
+			continue;
+		if(!s->defined)
+			fprintf(stderr, "tran: %s not defined; common\n", s->name);
+		sz = tsize(s->t);
+		if(s->t->k == T_ARRAY && s->t->n < 0)
+			sz = 2;
+		a = (a+1) & ~1;
+		s->addr = a;
+		a += sz;
+	}
+	for(i = 0; i < nstr; i++) {
+		strs[i].addr = a;
+		a += strs[i].n+1;
+	}
+	a = (a+1) & ~1;
+	if(a > 0140000-010000)
+		fatal("data too big", 0);
+
+	fh = fopen(sf("%s.h", out), "w");
+	if(fh == 0)
+		fatal("can't create %s.h", out);
+	fprintf(fh, "/* made by tran; do not edit */\n");
+	fprintf(fh, "#define\tDATAEND\t%d\n", a);
+	for(s = gfirst; s; s = s->gnext) {
+		if(s->cls == S_GLOBAL) {
+			fprintf(fh, "#define\tG_%s\t%d\n", s->cname, s->addr);
+			fprintf(fh, "#define\tZ_%s\t%d\n", s->cname, tsize(s->t));
+		}
+		if(s->cls == S_FUNC) {
+			fprintf(fh, "#define\tF_%s\t%d\n", s->cname,
+			    s->fid? s->fid: fid(s));
+			fprintf(fh, "#define\tG_%s\tF_%s\n", s->cname, s->cname);
+		}
+	}
+	for(i = 0; i < nstr; i++)
+		fprintf(fh, "#define\tS_%d\t%d\n", i, strs[i].addr);
+	for(g = gmembs; g; g = g->next)
+		if(!g->ambig)
+			fprintf(fh, "#define\tM_%s\t%d\n", g->name, g->off);
+	for(st = stags; st; st = st->next) {
+		if(st->name == 0 || !st->defined)
+			continue;
+		fprintf(fh, "#define\tZS_%s\t%d\n", st->name, st->size);
+		for(m = st->mem; m; m = m->next)
+			fprintf(fh, "#define\tM_%s_%s\t%d\n", st->name,
+			    m->name, m->off);
+	}
+	for(mp = nums; mp; mp = mp->next)
+		fprintf(fh, "#define\tD_%s\t(%s)\n", mp->name, mp->body);
+	fclose(fh);
+
+	/* initial data, strings and the function table */
+	fprintf(fc, "\nvoid\nk_init(void)\n{\n");
+	for(s = gfirst; s; s = s->gnext)
+		for(in = s->init; in; in = in->next)
+			fprintf(fc, "\t%s;\n", store(in->t,
+			    sf("G_%s+%d", s->cname, in->off), gen(in->e)));
+	for(i = 0; i < nstr; i++) {
+		fprintf(fc, "\tmemcpy(&mem[S_%d], \"", i);
+		for(b = strs[i].s; b < strs[i].s+strs[i].n; b++)
+			fprintf(fc, "\\%03o", *b&0377);
+		fprintf(fc, "\", %d);\n", strs[i].n+1);
+	}
+	fprintf(fc, "}\n\nint (*ftab[])() = {\n\t0,\n");
+	for(i = 1; i <= nfid; i++)
+		fprintf(fc, "\tk_%s,\n", fids[i]->cname);
+	fprintf(fc, "};\nint nftab = %d;\n", nfid+1);
+	fclose(fc);
+
+	/* prototypes */
+	fh = fopen(sf("%s.p", out), "w");
+	for(s = gfirst; s; s = s->gnext)
+		if(s->cls == S_FUNC)
+			fprintf(fh, "int k_%s(int, int, int, int, int, int, int, int);\n",
+			    s->cname);
+	fclose(fh);
+	return errs != 0;
+}
@@ -0,0 +1,1001 @@
+# a source tree: make it, look at it,
+# read it back and take it away
+mkdir /src
+mkdir /src/d0
+creat /src/d0/f00.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 1760
+close 3
+creat /src/d0/f01.c 0644
+write 3 2048
+write 3 1952
+close 3
+creat /src/d0/f02.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 1760
+close 3
+creat /src/d0/f03.c 0644
+write 3 300
+close 3
+creat /src/d0/f04.c 0644
+write 3 2048
+write 3 452
+close 3
+creat /src/d0/f05.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 1760
+close 3
+creat /src/d0/f06.c 0644
+write 3 1500
+close 3
+creat /src/d0/f07.c 0644
+write 3 300
+close 3
+creat /src/d0/f08.c 0644
+write 3 300
+close 3
+creat /src/d0/f09.c 0644
+write 3 800
+close 3
+creat /src/d0/f10.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 856
+close 3
+creat /src/d0/f11.c 0644
+write 3 2048
+write 3 1952
+close 3
+creat /src/d0/f12.c 0644
+write 3 2048
+write 3 452
+close 3
+creat /src/d0/f13.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 1760
+close 3
+creat /src/d0/f14.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 856
+close 3
+mkdir /src/d1
+creat /src/d1/f00.c 0644
+write 3 1500
+close 3
+creat /src/d1/f01.c 0644
+write 3 1500
+close 3
+creat /src/d1/f02.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 1760
+close 3
+creat /src/d1/f03.c 0644
+write 3 300
+close 3
+creat /src/d1/f04.c 0644
+write 3 1500
+close 3
+creat /src/d1/f05.c 0644
+write 3 2048
+write 3 452
+close 3
+creat /src/d1/f06.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 1760
+close 3
+creat /src/d1/f07.c 0644
+write 3 800
+close 3
+creat /src/d1/f08.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 856
+close 3
+creat /src/d1/f09.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 1760
+close 3
+creat /src/d1/f10.c 0644
+write 3 2048
+write 3 452
+close 3
+creat /src/d1/f11.c 0644
+write 3 2048
+write 3 1952
+close 3
+creat /src/d1/f12.c 0644
+write 3 2048
+write 3 1952
+close 3
+creat /src/d1/f13.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 856
+close 3
+creat /src/d1/f14.c 0644
+write 3 300
+close 3
+mkdir /src/d2
+creat /src/d2/f00.c 0644
+write 3 800
+close 3
+creat /src/d2/f01.c 0644
+write 3 2048
+write 3 1952
+close 3
+creat /src/d2/f02.c 0644
+write 3 2048
+write 3 1952
+close 3
+creat /src/d2/f03.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 856
+close 3
+creat /src/d2/f04.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 1760
+close 3
+creat /src/d2/f05.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 856
+close 3
+creat /src/d2/f06.c 0644
+write 3 1500
+close 3
+creat /src/d2/f07.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 856
+close 3
+creat /src/d2/f08.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 1760
+close 3
+creat /src/d2/f09.c 0644
+write 3 2048
+write 3 1952
+close 3
+creat /src/d2/f10.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 856
+close 3
+creat /src/d2/f11.c 0644
+write 3 300
+close 3
+creat /src/d2/f12.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 1760
+close 3
+creat /src/d2/f13.c 0644
+write 3 2048
+write 3 452
+close 3
+creat /src/d2/f14.c 0644
+write 3 1500
+close 3
+mkdir /src/d3
+creat /src/d3/f00.c 0644
+write 3 300
+close 3
+creat /src/d3/f01.c 0644
+write 3 1500
+close 3
+creat /src/d3/f02.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 1760
+close 3
+creat /src/d3/f03.c 0644
+write 3 2048
+write 3 452
+close 3
+creat /src/d3/f04.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 1760
+close 3
+creat /src/d3/f05.c 0644
+write 3 1500
+close 3
+creat /src/d3/f06.c 0644
+write 3 2048
+write 3 452
+close 3
+creat /src/d3/f07.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 856
+close 3
+creat /src/d3/f08.c 0644
+write 3 300
+close 3
+creat /src/d3/f09.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 1760
+close 3
+creat /src/d3/f10.c 0644
+write 3 800
+close 3
+creat /src/d3/f11.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 856
+close 3
+creat /src/d3/f12.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 856
+close 3
+creat /src/d3/f13.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 1760
+close 3
+creat /src/d3/f14.c 0644
+write 3 1500
+close 3
+mkdir /src/d4
+creat /src/d4/f00.c 0644
+write 3 300
+close 3
+creat /src/d4/f01.c 0644
+write 3 300
+close 3
+creat /src/d4/f02.c 0644
+write 3 2048
+write 3 1952
+close 3
+creat /src/d4/f03.c 0644
+write 3 800
+close 3
+creat /src/d4/f04.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 1760
+close 3
+creat /src/d4/f05.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 856
+close 3
+creat /src/d4/f06.c 0644
+write 3 1500
+close 3
+creat /src/d4/f07.c 0644
+write 3 2048
+write 3 452
+close 3
+creat /src/d4/f08.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 1760
+close 3
+creat /src/d4/f09.c 0644
+write 3 800
+close 3
+creat /src/d4/f10.c 0644
+write 3 2048
+write 3 1952
+close 3
+creat /src/d4/f11.c 0644
+write 3 2048
+write 3 1952
+close 3
+creat /src/d4/f12.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 856
+close 3
+creat /src/d4/f13.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 856
+close 3
+creat /src/d4/f14.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 1760
+close 3
+mkdir /src/d5
+creat /src/d5/f00.c 0644
+write 3 2048
+write 3 1952
+close 3
+creat /src/d5/f01.c 0644
+write 3 300
+close 3
+creat /src/d5/f02.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 856
+close 3
+creat /src/d5/f03.c 0644
+write 3 1500
+close 3
+creat /src/d5/f04.c 0644
+write 3 800
+close 3
+creat /src/d5/f05.c 0644
+write 3 2048
+write 3 1952
+close 3
+creat /src/d5/f06.c 0644
+write 3 2048
+write 3 452
+close 3
+creat /src/d5/f07.c 0644
+write 3 1500
+close 3
+creat /src/d5/f08.c 0644
+write 3 1500
+close 3
+creat /src/d5/f09.c 0644
+write 3 2048
+write 3 1952
+close 3
+creat /src/d5/f10.c 0644
+write 3 300
+close 3
+creat /src/d5/f11.c 0644
+write 3 300
+close 3
+creat /src/d5/f12.c 0644
+write 3 2048
+write 3 1952
+close 3
+creat /src/d5/f13.c 0644
+write 3 2048
+write 3 2048
+write 3 2048
+write 3 856
+close 3
+creat /src/d5/f14.c 0644
+write 3 2048
+write 3 1952
+close 3
+sync
+chdir /src/d3
+stat f00.c
+stat f01.c
+stat f02.c
+stat f03.c
+stat f04.c
+stat f05.c
+stat f06.c
+stat f07.c
+stat f08.c
+stat f09.c
+stat f10.c
+stat f11.c
+stat f12.c
+stat f13.c
+stat f14.c
+chdir /
+stat /src/d1/f10.c
+stat /src/d0/f14.c
+stat /src/d5/f02.c
+stat /src/d5/f09.c
+stat /src/d2/f04.c
+stat /src/d2/f09.c
+stat /src/d5/f14.c
+stat /src/d3/f03.c
+stat /src/d4/f01.c
+stat /src/d1/f13.c
+stat /src/d1/f02.c
+stat /src/d5/f01.c
+stat /src/d1/f11.c
+stat /src/d4/f06.c
+stat /src/d0/f01.c
+stat /src/d1/f09.c
+stat /src/d1/f06.c
+stat /src/d0/f02.c
+stat /src/d2/f12.c
+stat /src/d5/f11.c
+stat /src/d3/f02.c
+stat /src/d5/f07.c
+stat /src/d4/f07.c
+stat /src/d3/f04.c
+stat /src/d2/f07.c
+stat /src/d1/f01.c
+stat /src/d4/f02.c
+stat /src/d0/f03.c
+stat /src/d0/f11.c
+stat /src/d1/f12.c
+stat /src/d2/f08.c
+stat /src/d4/f09.c
+stat /src/d5/f08.c
+stat /src/d0/f06.c
+stat /src/d5/f05.c
+stat /src/d1/f00.c
+stat /src/d3/f06.c
+stat /src/d0/f05.c
+stat /src/d3/f14.c
+stat /src/d4/f11.c
+stat /src/d3/f10.c
+stat /src/d5/f03.c
+stat /src/d4/f14.c
+stat /src/d0/f04.c
+stat /src/d2/f03.c
+stat /src/d4/f00.c
+stat /src/d2/f00.c
+stat /src/d1/f04.c
+stat /src/d5/f12.c
+stat /src/d3/f07.c
+stat /src/d0/f12.c
+stat /src/d5/f04.c
+stat /src/d4/f08.c
+stat /src/d2/f01.c
+stat /src/d5/f06.c
+stat /src/d5/f00.c
+stat /src/d5/f10.c
+stat /src/d0/f07.c
+stat /src/d4/f04.c
+stat /src/d1/f03.c
+stat /src/d3/f12.c
+stat /src/d2/f05.c
+stat /src/d3/f11.c
+stat /src/d0/f08.c
+stat /src/d2/f06.c
+stat /src/d5/f13.c
+stat /src/d0/f10.c
+stat /src/d1/f14.c
+stat /src/d2/f11.c
+stat /src/d0/f13.c
+stat /src/d1/f05.c
+stat /src/d3/f09.c
+stat /src/d4/f13.c
+stat /src/d2/f13.c
+stat /src/d1/f07.c
+stat /src/d2/f02.c
+stat /src/d4/f12.c
+stat /src/d4/f05.c
+stat /src/d2/f14.c
+stat /src/d3/f13.c
+stat /src/d3/f01.c
+stat /src/d1/f08.c
+stat /src/d2/f10.c
+stat /src/d3/f05.c
+stat /src/d3/f08.c
+stat /src/d3/f00.c
+stat /src/d4/f03.c
+stat /src/d4/f10.c
+stat /src/d0/f09.c
+stat /src/d0/f00.c
+open /src/d0/f00.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d0/f01.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d0/f02.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d0/f03.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d0/f04.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d0/f05.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d0/f06.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d0/f07.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d0/f08.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d0/f09.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d0/f10.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d0/f11.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d0/f12.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d0/f13.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d0/f14.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d1/f00.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d1/f01.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d1/f02.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d1/f03.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d1/f04.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d1/f05.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d1/f06.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d1/f07.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d1/f08.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d1/f09.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d1/f10.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d1/f11.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d1/f12.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d1/f13.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d1/f14.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d2/f00.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d2/f01.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d2/f02.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d2/f03.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d2/f04.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d2/f05.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d2/f06.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d2/f07.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d2/f08.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d2/f09.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d2/f10.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d2/f11.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d2/f12.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d2/f13.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d2/f14.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d3/f00.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d3/f01.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d3/f02.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d3/f03.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d3/f04.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d3/f05.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d3/f06.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d3/f07.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d3/f08.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d3/f09.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d3/f10.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d3/f11.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d3/f12.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d3/f13.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d3/f14.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d4/f00.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d4/f01.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d4/f02.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d4/f03.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d4/f04.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d4/f05.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d4/f06.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d4/f07.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d4/f08.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d4/f09.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d4/f10.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d4/f11.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d4/f12.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d4/f13.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d4/f14.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d5/f00.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d5/f01.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d5/f02.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d5/f03.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d5/f04.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d5/f05.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d5/f06.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d5/f07.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d5/f08.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d5/f09.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d5/f10.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d5/f11.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d5/f12.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d5/f13.c 0
+read 3 8192
+read 3 8192
+close 3
+open /src/d5/f14.c 0
+read 3 8192
+read 3 8192
+close 3
+unlink /src/d0/f00.c
+unlink /src/d0/f01.c
+unlink /src/d0/f02.c
+unlink /src/d0/f03.c
+unlink /src/d0/f04.c
+unlink /src/d0/f05.c
+unlink /src/d0/f06.c
+unlink /src/d0/f07.c
+unlink /src/d0/f08.c
+unlink /src/d0/f09.c
+unlink /src/d0/f10.c
+unlink /src/d0/f11.c
+unlink /src/d0/f12.c
+unlink /src/d0/f13.c
+unlink /src/d0/f14.c
+unlink /src/d1/f00.c
+unlink /src/d1/f01.c
+unlink /src/d1/f02.c
+unlink /src/d1/f03.c
+unlink /src/d1/f04.c
+unlink /src/d1/f05.c
+unlink /src/d1/f06.c
+unlink /src/d1/f07.c
+unlink /src/d1/f08.c
+unlink /src/d1/f09.c
+unlink /src/d1/f10.c
+unlink /src/d1/f11.c
+unlink /src/d1/f12.c
+unlink /src/d1/f13.c
+unlink /src/d1/f14.c
+unlink /src/d2/f00.c
+unlink /src/d2/f01.c
+unlink /src/d2/f02.c
+unlink /src/d2/f03.c
+unlink /src/d2/f04.c
+unlink /src/d2/f05.c
+unlink /src/d2/f06.c
+unlink /src/d2/f07.c
+unlink /src/d2/f08.c
+unlink /src/d2/f09.c
+unlink /src/d2/f10.c
+unlink /src/d2/f11.c
+unlink /src/d2/f12.c
+unlink /src/d2/f13.c
+unlink /src/d2/f14.c
+unlink /src/d3/f00.c
+unlink /src/d3/f01.c
+unlink /src/d3/f02.c
+unlink /src/d3/f03.c
+unlink /src/d3/f04.c
+unlink /src/d3/f05.c
+unlink /src/d3/f06.c
+unlink /src/d3/f07.c
+unlink /src/d3/f08.c
+unlink /src/d3/f09.c
+unlink /src/d3/f10.c
+unlink /src/d3/f11.c
+unlink /src/d3/f12.c
+unlink /src/d3/f13.c
+unlink /src/d3/f14.c
+unlink /src/d4/f00.c
+unlink /src/d4/f01.c
+unlink /src/d4/f02.c
+unlink /src/d4/f03.c
+unlink /src/d4/f04.c
+unlink /src/d4/f05.c
+unlink /src/d4/f06.c
+unlink /src/d4/f07.c
+unlink /src/d4/f08.c
+unlink /src/d4/f09.c
+unlink /src/d4/f10.c
+unlink /src/d4/f11.c
+unlink /src/d4/f12.c
+unlink /src/d4/f13.c
+unlink /src/d4/f14.c
+unlink /src/d5/f00.c
+unlink /src/d5/f01.c
+unlink /src/d5/f02.c
+unlink /src/d5/f03.c
+unlink /src/d5/f04.c
+unlink /src/d5/f05.c
+unlink /src/d5/f06.c
+unlink /src/d5/f07.c
+unlink /src/d5/f08.c
+unlink /src/d5/f09.c
+unlink /src/d5/f10.c
+unlink /src/d5/f11.c
+unlink /src/d5/f12.c
+unlink /src/d5/f13.c
+unlink /src/d5/f14.c
+rmdir /src/d5
+rmdir /src/d4
+rmdir /src/d3
+rmdir /src/d2
+rmdir /src/d1
+rmdir /src/d0
+rmdir /src
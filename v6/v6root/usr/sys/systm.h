@@ -46,9 +46,43 @@ char	curpri;			/* more scheduling */
 int	maxmem;			/* actual max memory per process */
 int	*lks;			/* pointer to clock device */
 int	rootdev;		/* dev of root see conf.c */
-int	swapdev;		/* dev of swap see conf.c */
+int	swapdev;		/* first dev of swap see main.c */
 int	swplo;			/* block number of swap space */
-int	nswap;			/* size of swap space */
+int	nswap;			/* swap blocks on each dev */
+int	nswdev;			/* number of swap devs */
+int	rdsize;			/* size of ram disk see conf.c */
 int	updlock;		/* lock for sync */
 int	rablock;		/* block to be read ahead */
+char	kpflag;			/* kernel profile on, see kprof.c */
 char	regloc[];		/* locs. of saved user registers (trap.c) */
+/*
+ * The swap devices, from conf.c;
+ * a 0 size ends the table.
+ */
+struct	swtab
+{
+	int	sw_dev;			/* major, minor */
+	int	sw_nblk;		/* blocks from swplo */
+} swdevs[];
+/*
+ * Counts of system activity,
+ * read by iostat to measure the
+ * buffer cache, name lookup and
+ * the aging of proc entries in clock.
+ * They wrap; only differences
+ * are meaningful.
+ */
+struct	sysstat
+{
+	int	ss_bread;	/* blocks asked of bread */
+	int	ss_bhit;	/* ... found in a buffer */
+	int	ss_read;	/* blocks read from devices */
+	int	ss_write;	/* blocks written to devices */
+	int	ss_iget;	/* calls to iget */
+	int	ss_ihit;	/* ... found in core */
+	int	ss_namei;	/* directories searched by namei */
+	int	ss_dirent;	/* ... entries looked at */
+	int	ss_syscall;	/* system calls */
+	int	ss_stime;	/* ticks in system, not idle */
+	int	ss_age[4];	/* ticks that aged 1, 2-3, 4-15, 16+ procs */
+} sysstat;
@@ -13,3 +13,24 @@ struct text
 	char	x_count;	/* reference count */ // 以所有进程为对象的参照计数器
 	char	x_ccount;	/* number of loaded references */ // 以内存中的进程为对象的参照计数器
 } text[NTEXT];
+
+/*
+ * Mapped file structure.
+ * One allocated per file mapped
+ * read-only into data space (see smap);
+ * the core copy is shared by all
+ * processes mapping the file and is
+ * never swapped.
+ * Manipulated by text.c
+ */
+struct mfile
+{
+	int	m_caddr;	/* core address */
+	int	m_size;		/* size (*64) */
+	int	*m_iptr;	/* inode of file */
+	char	m_count;	/* reference count */
+	char	m_flag;
+} mfile[NMFILE];
+
+/* flags */
+#define	MLOAD	01		/* being read in; map writable */
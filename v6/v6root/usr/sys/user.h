@@ -52,6 +52,8 @@ struct user
 	int	*u_ar0;			/* address of users saved R0 */ // 系统调用处理中，操作用户进程的通用寄存器或者PSW时使用
 	int	u_prof[4];		/* profile arguments */ // 用于统计
 	char	u_intflg;		/* catch intr from sys */ // 标志变量，用于判断系统调用处理中是否发生了对信号的处理
+	int	*u_mfile;		/* mapped file segment */
+	int	u_mseg;			/* its first data segment */
 					/* kernel stack per user
 					 * extends from u + USIZE*64
 					 * backward not to reach here
@@ -42,7 +42,11 @@ int	ssymflg;
 int	ssymval;
 int	signo;
 char	line[128];
+#define	BLKREQ	8	/* block request = word request + BLKREQ */
+#define	CBSIZ	32	/* words read at a time from process */
 int	regbuf[512];
+int	cbuf[2][CBSIZ];
+char	*cbaddr[2] { -1, -1 };
 char	**uregs	&regbuf[512];
 char	*rtsize;
 int	loccsv;
@@ -611,6 +615,7 @@ runcom()
 					lastbp = 0;
 				} else {
 					ptrace(WUSER,pid,bkptl[w].loc,bkptl[w].ins);
+					tflush();
 				}
 				bkptl[w].loc = 0;
 				bkptl[w].flag = 0;
@@ -665,6 +670,7 @@ runcom()
 			ptrace(CONTIN, pid, 0, 0);
 			bpwait(1);
 			ptrace(WUSER, pid, w, 03);
+			tflush();
 			ptrace(WUREGS, pid, 2*(512+ps), uregs[ps]&~020);
 			lastbp = 0;
 		}
@@ -680,6 +686,7 @@ runcom()
 		}
 		lastbp = w;
 		ptrace(WUSER, pid, w, bkptl[i].ins);
+		tflush();
 		ptrace(WUREGS, pid, 2*(512+pc), w);
 		ptrace(WUREGS, pid, 2*(512+ps), uregs[ps]|020);
 		printf("Breakpoint: ");
@@ -736,6 +743,7 @@ setbp(runflag)
 			}
 			bkptl[w].ins = i1;
 			ptrace(WUSER, pid, l, 03);
+			tflush();
 			if (errno) {
 				printf("Can't set breakpoint ");
 				psymoff(bkptl[w].loc);
@@ -783,6 +791,7 @@ collinfo()
 {
 	register i;
 
+	tflush();
 	for (i=0; i<9; i++)
 		uregs[reglist[i].roffs] =
 		    ptrace(RUREGS, pid, 2*(512+reglist[i].roffs), 0);
@@ -889,9 +898,9 @@ char *aaddr;
 
 	addr = aaddr;
 	if (pid) {		/* tracing on? */
-		w = ptrace(space==DSP?RUSER:RIUSER, pid, addr, 0);
+		w = tget(addr, space);
 		if (addr&01) {
-			w1 = ptrace(space==DSP?RUSER:RIUSER, pid, addr+1, 0);
+			w1 = tget(addr+1, space);
 			w = (w>>8)&0377 | (w1<<8);
 		}
 		errflg = errno;
@@ -917,6 +926,36 @@ char *aaddr;
 	return(w);
 }
 
+/*
+ * Get a word from the traced process.
+ * Words are read a block at a time
+ * and the last block of each space is
+ * kept until the process runs or is written.
+ */
+tget(addr, space)
+char *addr;
+{
+	register char *a;
+	register req;
+
+	req = space==DSP? RUSER: RIUSER;
+	a = addr & ~(2*CBSIZ-1);
+	if (a != cbaddr[space]) {
+		cbaddr[space] = -1;
+		if (ptrace(req+BLKREQ, pid, a, cbuf[space], 2*CBSIZ) != 2*CBSIZ)
+			return(ptrace(req, pid, addr, 0));
+		cbaddr[space] = a;
+	}
+	errno = 0;
+	return(cbuf[space][(addr-a)>>1]);
+}
+
+tflush()
+{
+	cbaddr[DSP] = -1;
+	cbaddr[ISP] = -1;
+}
+
 symset()
 {
 	symct = symlen;
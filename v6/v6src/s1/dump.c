@@ -3,6 +3,18 @@
 /*
  * incremental dump
  * dump fisbuodh filesystem
+ *
+ * A reader process walks the i-list and sends the
+ * tape image down a pipe to the writer, which puts
+ * it on tape.  The reader gathers the blocks of
+ * files in batches and reads each batch in
+ * ascending disk order, consecutive blocks at once.
+ *
+ * Ahead of the files goes a table of contents
+ * naming each directory and each file dumped,
+ * and where on the tape each one is,
+ * so restor can find files by name.
+ *
  * f take output tape from arglist
  * i from date in /etc/dtab
  * s specify tape size in feet (feet = blocks/9)
@@ -12,6 +24,7 @@
  * d dump specified number of days
  * h dump specified number of hours
  * a on incremental dump, dump files even >= MAXSIZE
+ * r specify blocks per tape record
  */
 
 char	*dargv[]
@@ -25,6 +38,13 @@ char	*dargv[]
 #include "/usr/sys/ino.h"
 #include "/usr/sys/filsys.h"
 #define	MAXSIZE	1000
+#define	MAXREC	20
+#define	NBATCH	40
+#define	MAXRUN	8
+#define	NDIRS	787
+#define	NTENT	23
+#define	TDIR	01
+#define	TLAST	02
 struct filsys sblock;
 struct
 {
@@ -49,17 +69,53 @@ int	cflg;
 int	aflg;
 char	*tsize	19000;
 char	*taddr;
+int	tbuf[MAXREC*256];
+int	ntrec	10;
+int	trecc;
+int	pipef[2];
+int	bslot[NBATCH][257];	/* flag word and tape block */
+int	bbno[NBATCH];		/* disk block to read, or 0 */
+int	border[NBATCH];		/* slots in disk block order */
+int	nslot;
+int	rbuf[MAXRUN*256];
+char	*nread;
+char	*nrun;
+char	*nwrit;
+struct	htab
+{
+	int	hino;
+	int	hpino;
+	char	hname[14];
+	int	htape;		/* tape of the header, from 0 */
+	char	*hblk;		/* and block on it */
+} *htab;
+struct
+{
+	int	t_nent;		/* entries used */
+	int	t_flag;		/* TDIR, TLAST */
+	struct	htab t_ent[NTENT];
+	int	t_pad[1];
+} tocb;
+struct	dent
+{
+	int	e_ino;
+	char	e_name[14];
+};
+int	toc;
+int	nhent;
+int	nfent;
+int	*tabase;
 
 main(argc, argv)
 char **argv;
 {
 	char *key;
-	int s, i, nfil, nblk, f;
+	int s, i, nfil, nblk, f, pid;
 	register *tap;
 	register struct inode *ip;
 	int ino;
 
-	ofile = "/dev/mt0";
+	ofile = "/dev/rmt0";
 	time(date);
 	if(argc == 1) {
 		argv = dargv;
@@ -109,6 +165,16 @@ char **argv;
 		argc--;
 		continue;
 
+	case 'r': /* blocks per record */
+		ntrec = number(argv[1]);
+		if(ntrec <= 0 || ntrec > MAXREC) {
+			printf("bad record size\n");
+			exit();
+		}
+		argv++;
+		argc--;
+		continue;
+
 	case 'u': /* rewrite date */
 		dflg++;
 		continue;
@@ -203,6 +269,10 @@ char **argv;
 	printf("%l files\n%l blocks\n", nfil, nblk);
 	i = ldiv(0, nblk, ldiv(0, tsize, 10));
 	printf("%l.%l tapes\n", i/10, i%10);
+	toc = tocinit();
+	if(toc)
+		tbase(1 + size(0, sblock.s_isize*32) +
+		    tblks(nhent) + tblks(nfent));
 	tap = buf;
 	clrbuf(tap);
 	*tap++ = sblock.s_isize;
@@ -212,6 +282,7 @@ char **argv;
 	*tap++ = ddate[0];
 	*tap++ = ddate[1];
 	*tap++ = tsize;
+	*tap++ = toc;
 	swrite(buf);
 	i = size(0, sblock.s_isize*32);
 	tap = talist;
@@ -219,16 +290,31 @@ char **argv;
 		bwrite(tap);
 		tap =+ 256;
 	}
-	tap = talist;
-	for(i=0; i<sblock.s_isize; i++) {
-		bread(i+2, buf);
-		for(ip = &buf[0]; ip < &buf[256]; ip++) {
-			if(*tap && *tap != -1)
-				dump(ip, *tap-1);
-			tap++;
-		}
+	if(toc)
+		wtoc();
+	if(pipe(pipef) < 0) {
+		printf("cannot make pipe\n");
+		exit();
+	}
+	pid = fork();
+	if(pid == 0) {
+		close(pipef[0]);
+		close(fo);
+		reader();
+		exit(0);
+	}
+	if(pid < 0) {
+		printf("cannot fork\n");
+		exit();
+	}
+	close(pipef[1]);
+	writer();
+	while((i = wait(&s)) != pid && i != -1)
+		;
+	if(s != 0) {
+		printf("dump failed\n");
+		exit();
 	}
-	printf("%l phase errors\n", pher);
 	if(!dflg)
 		exit();
 	for(i=0; i<10; i++)
@@ -271,7 +357,383 @@ int *d;
 		printf(ctime(d));
 }
 
-dump(ip, sz)
+/*
+ * Find the directories and their names
+ * for the table of contents, as ncheck does.
+ * Returns 0 if there is no room for them.
+ */
+tocinit()
+{
+	register struct inode *ip;
+	register struct htab *hp;
+	register struct dent *dp;
+	int i, ino, off;
+
+	htab = sbrk(NDIRS * sizeof tocb.t_ent[0]);
+	if(htab == -1)
+		goto bad;
+	for(hp = htab; hp < &htab[NDIRS]; hp++)
+		hp->hino = 0;
+	ino = 0;
+	for(i=0; i<sblock.s_isize; i++) {
+		bread(i+2, buf);
+		for(ip = &buf[0]; ip < &buf[256]; ip++) {
+			ino++;
+			if(isdir(ip) && lookup(ino, 1) == 0) {
+				brk(htab);
+				goto bad;
+			}
+		}
+	}
+	ino = 0;
+	for(i=0; i<sblock.s_isize; i++) {
+		bread(i+2, buf);
+		for(ip = &buf[0]; ip < &buf[256]; ip++) {
+			ino++;
+			if(!isdir(ip))
+				continue;
+			for(off=0; dp = dread(ip, off, ino); off =+ 16) {
+				if(dp->e_ino == 0 || dotname(dp))
+					continue;
+				if((hp = lookup(dp->e_ino, 0)) == 0) {
+					if(dp->e_ino <= sblock.s_isize*16 &&
+					    talist[dp->e_ino-1] > 0)
+						nfent++;
+					continue;
+				}
+				hp->hpino = ino;
+				copy(dp->e_name, hp->hname, 14);
+			}
+		}
+	}
+	return(1);
+
+bad:
+	printf("too many directories; no table of contents\n");
+	return(0);
+}
+
+/*
+ * Write the table of contents: the blocks
+ * of directories, marked TDIR, then a name
+ * for each link to a file being dumped.
+ * The last block is marked TLAST.
+ * The files were placed on the tape for
+ * the nfent names tocinit found; if the
+ * directories have changed since, the
+ * names are cut or padded to that many.
+ */
+wtoc()
+{
+	register struct inode *ip;
+	register struct htab *hp;
+	register struct dent *dp;
+	int i, n, ino, off;
+
+	tocb.t_flag = TDIR;
+	for(hp = htab; hp < &htab[NDIRS]; hp++)
+		if(hp->hino)
+			tput(hp->hino, hp->hpino, hp->hname);
+	tout(0);
+	tocb.t_flag = 0;
+	n = 0;
+	ino = 0;
+	for(i=0; i<sblock.s_isize; i++) {
+		bread(i+2, buf);
+		for(ip = &buf[0]; ip < &buf[256]; ip++) {
+			ino++;
+			if(!isdir(ip))
+				continue;
+			for(off=0; dp = dread(ip, off, ino); off =+ 16) {
+				if(dp->e_ino == 0 || dotname(dp))
+					continue;
+				if(dp->e_ino > sblock.s_isize*16)
+					continue;
+				if(talist[dp->e_ino-1] <= 0 || lookup(dp->e_ino, 0))
+					continue;
+				if(n >= nfent)
+					continue;
+				tput(dp->e_ino, ino, dp->e_name);
+				n++;
+			}
+		}
+	}
+	while(n++ < nfent)
+		tput(0, 0, 0);
+	tout(TLAST);
+	brk(htab);
+}
+
+tput(i, pi, s)
+char *s;
+{
+	register struct htab *hp;
+
+	if(tocb.t_nent >= NTENT)
+		tout(0);
+	hp = &tocb.t_ent[tocb.t_nent++];
+	hp->hino = i;
+	hp->hpino = pi;
+	hp->htape = 0;
+	hp->hblk = 0;
+	if(i == 0) {
+		hp->hname[0] = 0;
+		return;
+	}
+	copy(s, hp->hname, 14);
+	if(talist[i-1] > 0)
+		faddr(i, &hp->htape);
+}
+
+/*
+ * Number of blocks the table
+ * takes for n entries.
+ */
+tblks(n)
+{
+
+	if(n == 0)
+		return(1);
+	return((n+NTENT-1) / NTENT);
+}
+
+/*
+ * Find where on the tape the files of
+ * each map block's worth of i-nodes begin,
+ * the first being n blocks from the start.
+ */
+tbase(n)
+{
+	register *tap, *bp, i;
+	int t, j;
+	char *b;
+
+	j = size(0, sblock.s_isize*32);
+	tabase = sbrk(j*4);
+	if(tabase == -1) {
+		printf("No memory\n");
+		exit();
+	}
+	t = 0;
+	b = n;
+	tap = talist;
+	for(bp = tabase; bp < &tabase[j*2]; bp =+ 2) {
+		bp[0] = t;
+		bp[1] = b;
+		for(i=0; i<256; i++, tap++)
+			if(*tap > 0) {
+				b =+ *tap;
+				while(b >= tsize) {
+					b =- tsize;
+					t++;
+				}
+			}
+	}
+}
+
+/*
+ * Put at ap the tape and block
+ * of the header of file i.
+ */
+faddr(i, ap)
+int *ap;
+{
+	register *tap, *p;
+	register t;
+	char *b;
+
+	i--;
+	p = &tabase[(i>>8)*2];
+	t = p[0];
+	b = p[1];
+	for(tap = &talist[i&~0377]; tap < &talist[i]; tap++)
+		if(*tap > 0) {
+			b =+ *tap;
+			while(b >= tsize) {
+				b =- tsize;
+				t++;
+			}
+		}
+	ap[0] = t;
+	ap[1] = b;
+}
+
+tout(last)
+{
+
+	tocb.t_flag =| last;
+	bwrite(&tocb);
+	tocb.t_nent = 0;
+}
+
+isdir(ip)
+struct inode *ip;
+{
+
+	return((ip->i_mode&IALLOC) && (ip->i_mode&IFMT) == IFDIR &&
+	    ip->i_nlink);
+}
+
+lookup(i, ef)
+{
+	register struct htab *hp;
+
+	for(hp = &htab[(i&077777)%NDIRS]; hp->hino;) {
+		if(hp->hino == i)
+			return(hp);
+		if(++hp >= &htab[NDIRS])
+			hp = htab;
+	}
+	if(ef == 0)
+		return(0);
+	if(++nhent >= NDIRS)
+		return(0);
+	hp->hino = i;
+	hp->hpino = 0;
+	hp->hname[0] = 0;
+	return(hp);
+}
+
+dotname(adp)
+{
+	register struct dent *dp;
+
+	dp = adp;
+	if(dp->e_name[0] == '.')
+		if(dp->e_name[1] == 0 || dp->e_name[1] == '.' && dp->e_name[2] == 0)
+			return(1);
+	return(0);
+}
+
+/*
+ * Return the directory entry at
+ * offset aoff in directory aip,
+ * or 0 past its end.
+ */
+dread(aip, aoff, ino)
+{
+	register b, off;
+	register struct inode *ip;
+	static xbuf[256];
+	static char dirb[512];
+
+	off = aoff;
+	ip = aip;
+	if(ip->i_size0 == 0 && off >= ip->i_size1)
+		return(0);
+	if((off&0777) == 0) {
+		if(off == 0177000) {
+			printf("monstrous directory %l\n", ino);
+			return(0);
+		}
+		if((ip->i_mode&ILARG) == 0) {
+			if(off >= 010000 || (b = ip->i_addr[off>>9]) == 0)
+				return(0);
+			bread(b, dirb);
+		} else {
+			if(off == 0) {
+				if(ip->i_addr[0] == 0)
+					return(0);
+				bread(ip->i_addr[0], xbuf);
+			}
+			if((b = xbuf[(off>>9)&0177]) == 0)
+				return(0);
+			bread(b, dirb);
+		}
+	}
+	return(&dirb[off&0777]);
+}
+
+copy(f, t, n)
+char *f, *t;
+{
+
+	while(n--)
+		*t++ = *f++;
+}
+
+/*
+ * The reader: send the tape image of
+ * each file to be dumped to the writer.
+ */
+reader()
+{
+	register *tap;
+	register struct inode *ip;
+	int i, t0[2], t1[2];
+
+	time(t0);
+	tap = talist;
+	for(i=0; i<sblock.s_isize; i++) {
+		bread(i+2, buf);
+		for(ip = &buf[0]; ip < &buf[256]; ip++) {
+			if(*tap && *tap != -1)
+				dump(ip, *tap-1, tap-talist+1);
+			tap++;
+		}
+	}
+	flushb();
+	time(t1);
+	printf("%l phase errors\n", pher);
+	prate("disk", nread, t0, t1);
+	printf("%l disk reads\n", nrun);
+}
+
+/*
+ * The writer: put on tape what
+ * comes from the reader.
+ */
+writer()
+{
+	register char *p;
+	register i, n;
+	int t0[2], t1[2];
+
+	time(t0);
+	p = bslot[0];
+	for(;;) {
+		for(i=0; i<514; i =+ n)
+			if((n = read(pipef[0], p+i, 514-i)) <= 0)
+				goto out;
+		if(bslot[0][0])
+			swrite(&bslot[0][1]); else
+			bwrite(&bslot[0][1]);
+	}
+out:
+	tflush();
+	tclose();
+	time(t1);
+	prate("tape", nwrit, t0, t1);
+}
+
+/*
+ * Print the rate of a stage.
+ */
+prate(s, n, t0, t1)
+char *s;
+int *t0, *t1;
+{
+	double b, t;
+
+	b = n;
+	if(n < 0)
+		b =+ 65536.;
+	t = (t1[0]-t0[0])*65536. + t1[1] - t0[1];
+	if(t1[1] < 0)
+		t =+ 65536.;
+	if(t0[1] < 0)
+		t =- 65536.;
+	if(t < 1.)
+		t = 1.;
+	printf("%s: %.0f blocks, %.3f MB/s\n", s, b, b*512./t/1000000.);
+}
+
+/*
+ * Dump the file i-node ip, number ino:
+ * a header, the i-node and its number,
+ * then sz blocks.
+ */
+dump(ip, sz, ino)
 struct inode *ip;
 {
 	register *p, *q, *r;
@@ -281,7 +743,8 @@ struct inode *ip;
 	clrbuf(p);
 	while(q < &ip->i_mtime[2])
 		*p++ = *q++;
-	swrite(dbuf);
+	*p = ino;
+	put(0, dbuf, 1);
 	if(ip->i_mode & (IFBLK&IFCHR)) {
 		if(sz != 0)
 			printf("special\n");
@@ -299,21 +762,18 @@ struct inode *ip;
 					if(*r) {
 						if(--sz < 0)
 							goto pe;
-						bread(*r, dbuf);
-						bwrite(dbuf);
+						put(*r, 0, 0);
 					}
 					continue;
 				}
 				if(--sz < 0)
 					goto pe;
-				bread(*q, dbuf);
-				bwrite(dbuf);
+				put(*q, 0, 0);
 			}
 		} else {
 			if(--sz < 0)
 				goto pe;
-			bread(*p, dbuf);
-			bwrite(dbuf);
+			put(*p, 0, 0);
 		}
 	}
 	if(sz)
@@ -323,10 +783,79 @@ struct inode *ip;
 pe:
 	clrbuf(dbuf);
 	while(--sz >= 0)
-		bwrite(dbuf);
+		put(0, dbuf, 0);
 	pher++;
 }
 
+/*
+ * Add the next tape block to the batch:
+ * disk block bno, or if bno is 0 a copy of b.
+ * flag is 1 for a header, which swrite checksums.
+ */
+put(bno, b, flag)
+int *b;
+{
+	if(nslot >= NBATCH)
+		flushb();
+	bslot[nslot][0] = flag;
+	if(bno == 0)
+		cpblk(b, &bslot[nslot][1]);
+	bbno[nslot++] = bno;
+}
+
+cpblk(f, t)
+int *f, *t;
+{
+	register i, *p, *q;
+
+	p = f;
+	q = t;
+	i = 256;
+	while(i--)
+		*q++ = *p++;
+}
+
+/*
+ * Read the disk blocks of the batch
+ * in ascending order, up to MAXRUN
+ * consecutive blocks in one read,
+ * then send the batch to the writer.
+ */
+flushb()
+{
+	register i, j;
+	int b, k, n;
+
+	n = 0;
+	for(i=0; i<nslot; i++) {
+		if((b = bbno[i]) == 0)
+			continue;
+		for(j=n; j>0 && bbno[border[j-1]]+0100000 > b+0100000; j--)
+			border[j] = border[j-1];	/* unsigned compare */
+		border[j] = i;
+		n++;
+	}
+	for(i=0; i<n; i =+ k) {
+		b = bbno[border[i]];
+		for(k=1; i+k<n && k<MAXRUN && bbno[border[i+k]]==b+k; k++)
+			;
+		nrun++;
+		nread =+ k;
+		seek(fi, b, 3);
+		if(read(fi, rbuf, k*512) != k*512) {
+			for(j=0; j<k; j++)
+				bread(b+j, &bslot[border[i+j]][1]);
+			continue;
+		}
+		for(j=0; j<k; j++)
+			cpblk(&rbuf[j*256], &bslot[border[i+j]][1]);
+	}
+	for(i=0; i<nslot; i++)
+		if(write(pipef[1], bslot[i], 514) != 514)
+			exit(1);
+	nslot = 0;
+}
+
 bread(bno, b)
 {
 
@@ -363,26 +892,71 @@ int *b;
 }
 
 bwrite(b)
+int *b;
 {
+	register i, *p, *q;
 
 	if(taddr == 0) {
 		if(fo != -1) {
 			printf("change tapes\n");
-			close(fo);
+			tclose();
 			rdline();
 		}
 		otape();
 	}
-wloop:
-	if(write(fo, b, 512) != 512) {
+	p = b;
+	q = &tbuf[trecc*256];
+	i = 256;
+	while(i--)
+		*q++ = *p++;
+	trecc++;
+	taddr++;
+	nwrit++;
+	if(taddr >= tsize) {
+		tflush();
+		taddr = 0;
+	} else
+	if(trecc >= ntrec)
+		tflush();
+}
+
+/*
+ * Write the blocks gathered in tbuf
+ * as a single tape record.
+ */
+tflush()
+{
+	register n;
+
+	if(trecc == 0)
+		return;
+	n = trecc*512;
+	while(write(fo, tbuf, n) != n) {
 		printf("write error\n");
+		/*
+		 * Only the first record on a tape is
+		 * written at once; the error in a queued
+		 * one shows here a record or more later,
+		 * and what was lost is not known.
+		 */
+		if(taddr != trecc)
+			exit(1);
 		rdline();
-		seek(fo, taddr, 3);
-		goto wloop;
 	}
-	taddr++;
-	if(taddr >= tsize)
-		taddr = 0;
+	trecc = 0;
+}
+
+/*
+ * Close the tape; errors in the
+ * last queued records show here.
+ */
+tclose()
+{
+
+	if(close(fo) < 0) {
+		printf("write error\n");
+		exit(1);
+	}
 }
 
 rdline()
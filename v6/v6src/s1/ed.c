@@ -29,11 +29,19 @@
 #define	READ	0
 #define	WRITE	1
 
+#define	NCACHE	8	/* temp file blocks kept in core */
+#define	NAHEAD	4	/* blocks read at once going forward */
+#define	NBLK	1023	/* limit on blocks in temp file */
+
+#define	NSTATE	16	/* DFA states kept */
+#define	NSET	9	/* words in a set of positions */
+
 int	peekc;
 int	lastc;
 char	savedfile[FNSIZE];
 char	file[FNSIZE];
 char	linebuf[LBSIZE];
+char	*linend;		/* the null ending the line from getline */
 char	rhsbuf[LBSIZE/2];
 char	expbuf[ESIZE+4];
 int	circfl;
@@ -63,11 +71,13 @@ char	*tfname;
 char	*loc1;
 char	*loc2;
 char	*locs;
-char	ibuff[512];
-int	iblock	-1;
-char	obuff[512];
-int	oblock	-1;
-int	ichanged;
+char	cbuff[NCACHE][512];
+int	cblock[NCACHE];
+int	cused[NCACHE];
+char	cdirty[NCACHE];
+int	cclock;
+int	nblock;
+int	lastbno;
 int	nleft;
 int	errfunc();
 int	*errlab	errfunc;
@@ -75,6 +85,29 @@ char	TMPERR[] "TMP";
 int	names[26];
 char	*braslist[NBRA];
 char	*braelist[NBRA];
+int	*gmin;
+
+/*
+ * Lines are first tried against a DFA made from
+ * the expression, and if it has a string of two or
+ * more plain characters, by a search for that;
+ * only lines that pass are matched by advance,
+ * which finds where the match is.
+ */
+char	*epos[ESIZE+2];		/* each element of expbuf */
+int	nelem;			/* 0 if DFA is not made yet */
+struct	dstate {
+	int	d_set[NSET];	/* positions reached */
+	int	d_acc;		/* 1 matched, 2 matched at end of line */
+	int	d_stop;		/* matched, or no positions left */
+	char	d_next[256];	/* next state+1 on each character */
+} dstate[NSTATE];
+int	nstate;
+int	dset[NSET];
+char	litp[ESIZE/2];		/* the longest required string */
+int	litn;
+int	litall;			/* the string is the whole expression */
+char	litskip[256];
 
 main(argc, argv)
 char **argv;
@@ -604,6 +637,8 @@ int (*f)();
 
 	nline = 0;
 	dot = a;
+	if (a < gmin)
+		gmin = a;
 	while ((*f)() == 0) {
 		if (dol >= endcore) {
 			if (sbrk(1024) == -1)
@@ -650,6 +685,8 @@ delete()
 	a1 = addr1;
 	a2 = addr2+1;
 	a3 = dol;
+	if (a1 < gmin)
+		gmin = a1;
 	dol =- a2 - a1;
 	do
 		*a1++ = *a2++;
@@ -668,12 +705,13 @@ getline(tl)
 	lp = linebuf;
 	bp = getblock(tl, READ);
 	nl = nleft;
-	tl =& ~0377;
+	tl =& ~077;
 	while (*lp++ = *bp++)
 		if (--nl == 0) {
-			bp = getblock(tl=+0400, READ);
+			bp = getblock(tl=+0100, READ);
 			nl = nleft;
 		}
+	linend = lp-1;
 	return(linebuf);
 }
 
@@ -687,7 +725,7 @@ putline()
 	tl = tline;
 	bp = getblock(tl, WRITE);
 	nl = nleft;
-	tl =& ~0377;
+	tl =& ~077;
 	while (*bp = *lp++) {
 		if (*bp++ == '\n') {
 			*--bp = 0;
@@ -695,52 +733,156 @@ putline()
 			break;
 		}
 		if (--nl == 0) {
-			bp = getblock(tl=+0400, WRITE);
+			bp = getblock(tl=+0100, WRITE);
 			nl = nleft;
 		}
 	}
 	nl = tline;
-	tline =+ (((lp-linebuf)+03)>>1)&077776;
+	tline =+ (((lp-linebuf)+017)>>3)&077776;
 	return(nl);
 }
 
+/*
+ * A line's address in the temp file is
+ * a block number in the top 10 bits and
+ * an offset in 16-byte units in the next 5;
+ * the low bit is left for marks.
+ */
 getblock(atl, iof)
 {
-	extern read(), write();
-	register bno, off;
-	
-	bno = (atl>>8)&0377;
-	off = (atl<<1)&0774;
-	if (bno >= 255) {
+	register bno, off, i;
+	int j;
+
+	bno = (atl>>6)&01777;
+	off = (atl<<3)&0760;
+	if (bno >= NBLK) {
 		puts(TMPERR);
 		error;
 	}
 	nleft = 512 - off;
-	if (bno==iblock) {
-		ichanged =| iof;
-		return(ibuff+off);
+	for (i=0; i<NCACHE; i++)
+		if (cblock[i]==bno)
+			goto found;
+	i = bfetch(bno);
+found:
+	if (++cclock < 0) {
+		for (j=0; j<NCACHE; j++)
+			cused[j] = 0;
+		cclock = 1;
+	}
+	cused[i] = cclock;
+	cdirty[i] =| iof;
+	return(cbuff[i]+off);
+}
+
+/*
+ * Bring block bno into the cache in place of
+ * the least recently used one and return its slot.
+ * When the blocks are being read in order,
+ * as by g and s walking the buffer,
+ * the next few come in with it in one read.
+ * New blocks at the end of the file are put
+ * in consecutive slots so that they can
+ * be written out together.
+ */
+bfetch(bno)
+{
+	extern read();
+	register i, n, s;
+
+	s = -1;
+	n = 1;
+	if (bno >= nblock) {
+		if ((i = bslot(bno-1)) >= 0 && (i+1)%NAHEAD != 0)
+			s = i+1;
+		else
+			s = lrugroup();
+	} else if (bno==lastbno+1) {
+		while (n<NAHEAD && bno+n<nblock && bslot(bno+n)<0)
+			n++;
+		if (n > 1)
+			s = lrugroup();
 	}
-	if (bno==oblock)
-		return(obuff+off);
-	if (iof==READ) {
-		if (ichanged)
-			blkio(iblock, ibuff, write);
-		ichanged = 0;
-		iblock = bno;
-		blkio(bno, ibuff, read);
-		return(ibuff+off);
+	if (s < 0) {
+		s = 0;
+		for (i=1; i<NCACHE; i++)
+			if (cused[i] < cused[s])
+				s = i;
 	}
-	if (oblock>=0)
-		blkio(oblock, obuff, write);
-	oblock = bno;
-	return(obuff+off);
+	for (i=s; i<s+n; i++) {
+		if (cdirty[i])
+			bflush(i);
+		cblock[i] = -1;
+	}
+	if (bno < nblock) {
+		blkio(bno, cbuff[s], n, read);
+		lastbno = bno+n-1;
+	} else
+		nblock = bno+1;
+	for (i=0; i<n; i++) {
+		cblock[s+i] = bno+i;
+		cused[s+i] = cclock;
+	}
+	return(s);
+}
+
+/*
+ * The first slot of the group of NAHEAD
+ * used least lately.
+ */
+lrugroup()
+{
+	register g, i, m;
+	int s, u;
+
+	s = 0;
+	u = 077777;
+	for (g=0; g<NCACHE; g=+NAHEAD) {
+		m = 0;
+		for (i=g; i<g+NAHEAD; i++)
+			if (cused[i] > m)
+				m = cused[i];
+		if (m < u) {
+			u = m;
+			s = g;
+		}
+	}
+	return(s);
+}
+
+/*
+ * Write the block in slot s, together with
+ * the dirty ones after it that follow it
+ * in the file.
+ */
+bflush(s)
+{
+	extern write();
+	register i, n;
+
+	for (n=1; s+n<NCACHE; n++)
+		if (cdirty[s+n]==0 || cblock[s+n]!=cblock[s]+n)
+			break;
+	blkio(cblock[s], cbuff[s], n, write);
+	for (i=s; i<s+n; i++)
+		cdirty[i] = 0;
+}
+
+bslot(bno)
+{
+	register i;
+
+	for (i=0; i<NCACHE; i++)
+		if (cblock[i]==bno)
+			return(i);
+	return(-1);
 }
 
-blkio(b, buf, iofcn)
+blkio(b, buf, n, iofcn)
 int (*iofcn)();
 {
 	seek(tfile, b, 3);
-	if ((*iofcn)(tfile, buf, 512) != 512) {
+	if ((*iofcn)(tfile, buf, n*512) != n*512) {
 		puts(TMPERR);
 		error;
 	}
@@ -753,10 +895,14 @@ init()
 
 	close(tfile);
 	tline = 0;
-	iblock = -1;
-	oblock = -1;
+	for (pid=0; pid<NCACHE; pid++) {
+		cblock[pid] = -1;
+		cdirty[pid] = 0;
+		cused[pid] = 0;
+	}
+	nblock = 0;
+	lastbno = -1;
 	tfname = "/tmp/exxxxx";
-	ichanged = 0;
 	pid = getpid();
 	for (p = &tfname[11]; p > &tfname[6];) {
 		*--p = (pid&07) + '0';
@@ -767,6 +913,7 @@ init()
 	brk(fendcore);
 	dot = zero = dol = fendcore;
 	endcore = fendcore - 2;
+	gmin = zero;
 }
 
 global(k)
@@ -800,16 +947,21 @@ global(k)
 	*gp++ = 0;
 	for (a1=zero; a1<=dol; a1++) {
 		*a1 =& ~01;
-		if (a1>=addr1 && a1<=addr2 && execute(0, a1)==k)
+		if (a1>=addr1 && a1<=addr2 && dmatch(getline(*a1))==k)
 			*a1 =| 01;
 	}
+	/*
+	 * Lines before gmin are as they were,
+	 * so the search for marks goes on from there.
+	 */
 	for (a1=zero; a1<=dol; a1++) {
 		if (*a1 & 01) {
 			*a1 =& ~01;
 			dot = a1;
 			globp = globuf;
+			gmin = a1+1;
 			commands();
-			a1 = zero;
+			a1 = gmin-1;
 		}
 	}
 }
@@ -972,6 +1124,8 @@ reverse(aa1, aa2)
 
 	a1 = aa1;
 	a2 = aa2;
+	if (a1 < gmin)
+		gmin = a1;
 	for (;;) {
 		t = *--a2;
 		if (a2 <= a1)
@@ -1007,6 +1161,7 @@ compile(aeof)
 			error;
 		return;
 	}
+	nelem = 0;
 	circfl = 0;
 	if (c=='^') {
 		c = getchar();
@@ -1114,6 +1269,8 @@ int *addr;
 		if (addr==zero)
 			return(0);
 		p1 = getline(*addr);
+		if (dmatch(p1)==0)
+			return(0);
 		locs = 0;
 	}
 	p2 = expbuf;
@@ -1227,6 +1384,244 @@ advance(alp, aep)
 	}
 }
 
+/*
+ * Say whether the expression matches
+ * somewhere in the line at as, which
+ * getline has just made.
+ */
+dmatch(as)
+char *as;
+{
+	register char *p;
+	register struct dstate *dp;
+	register n;
+
+	if (nelem == 0)
+		dfainit();
+	if (litn) {
+		if (find(as, linend) == 0)
+			return(0);
+		if (litall)
+			return(1);
+	}
+	p = as;
+	dp = dstate;
+	for (; *p; p++) {
+		if (dp->d_stop)
+			return(dp->d_acc);
+		if ((n = dp->d_next[*p&0377]) == 0)
+			n = dnext(dp, *p&0377) + 1;
+		dp = &dstate[n-1];
+	}
+	return(dp->d_acc != 0);
+}
+
+/*
+ * Find the elements of the expression
+ * and its longest run of plain characters,
+ * and make the start state.
+ * Brackets match nothing, so they are left out.
+ */
+dfainit()
+{
+	register char *ep;
+	register n;
+	char *rp, *lp;
+
+	nelem = 0;
+	nstate = 0;
+	litn = 0;
+	rp = 0;
+	lp = 0;
+	n = 0;
+	for (ep = expbuf; ; ) {
+		if (*ep == CBRA || *ep == CKET) {
+			ep =+ 2;
+			n = 0;
+			continue;
+		}
+		epos[nelem++] = ep;
+		if (*ep == CCHR) {
+			if (n++ == 0)
+				rp = ep;
+			if (n > litn) {
+				litn = n;
+				lp = rp;
+			}
+		} else
+			n = 0;
+		if (*ep == CEOF)
+			break;
+		switch (*ep & ~STAR) {
+		case CCHR:
+			ep =+ 2;
+			continue;
+		case CCL:
+		case NCCL:
+			ep =+ ep[1] + 1;
+			continue;
+		default:
+			ep++;
+		}
+	}
+	for (n=0; n<NSET; n++)
+		dset[n] = 0;
+	dset[0] = 1;
+	closure();
+	newstate();
+	if (litn < 2) {
+		litn = 0;
+		return;
+	}
+	litall = circfl==0 && litn==nelem-1;
+	for (n=0; n<litn; n++)
+		litp[n] = lp[2*n+1];
+	for (n=0; n<256; n++)
+		litskip[n] = litn;
+	for (n=0; n<litn-1; n++)
+		litskip[litp[n]&0377] = litn-1-n;
+}
+
+/*
+ * Boyer-Moore-Horspool search for the required
+ * string in s up to e; returns where it ends.
+ */
+find(s, e)
+char *s, *e;
+{
+	register char *p, *q, *l;
+
+	for (p = s+litn-1; p < e; p =+ litskip[*p&0377]) {
+		q = p;
+		l = &litp[litn-1];
+		while (*q == *l) {
+			if (l == litp)
+				return(p);
+			q--;
+			l--;
+		}
+	}
+	return(0);
+}
+
+/*
+ * Make the state that dp goes to on c.
+ * If the table is full, it is emptied
+ * and refilled from the start state.
+ */
+dnext(dp, c)
+struct dstate *dp;
+{
+	register char *ep;
+	register i, k;
+	int s[NSET];
+
+	for (i=0; i<NSET; i++) {
+		s[i] = dp->d_set[i];
+		dset[i] = 0;
+	}
+	for (k=0; k<nelem; k++) {
+		if ((s[k>>4] & (1<<(k&017))) == 0)
+			continue;
+		ep = epos[k];
+		switch (*ep & ~STAR) {
+		case CCHR:
+			if ((ep[1]&0377) != c)
+				continue;
+			break;
+		case CDOT:
+			break;
+		case CCL:
+			if (cclass(ep+1, c, 1))
+				break;
+			continue;
+		case NCCL:
+			if (cclass(ep+1, c, 0))
+				break;
+			continue;
+		default:
+			continue;
+		}
+		if (*ep & STAR)
+			i = k; else
+			i = k+1;
+		dset[i>>4] =| 1<<(i&017);
+	}
+	if (circfl == 0)
+		dset[0] =| 1;
+	closure();
+	for (i=0; i<nstate; i++) {
+		for (k=0; k<NSET; k++)
+			if (dstate[i].d_set[k] != dset[k])
+				goto no;
+		break;
+	no:;
+	}
+	if (i == nstate) {
+		if (nstate >= NSTATE) {
+			for (k=0; k<NSET; k++)
+				s[k] = dset[k];
+			for (k=0; k<NSET; k++)
+				dset[k] = 0;
+			dset[0] = 1;
+			closure();
+			nstate = 0;
+			newstate();
+			for (k=0; k<NSET; k++)
+				dset[k] = s[k];
+			return(newstate());
+		}
+		i = newstate();
+	}
+	dp->d_next[c] = i+1;
+	return(i);
+}
+
+/*
+ * Add to dset the elements after
+ * starred ones, which may match nothing.
+ */
+closure()
+{
+	register k;
+
+	for (k=0; k<nelem-1; k++)
+		if (dset[k>>4] & (1<<(k&017)))
+		if (*epos[k] & STAR)
+			dset[(k+1)>>4] =| 1<<((k+1)&017);
+}
+
+/*
+ * Add the set in dset as a new state.
+ */
+newstate()
+{
+	register struct dstate *dp;
+	register char *ep;
+	register k;
+
+	dp = &dstate[nstate];
+	dp->d_acc = 0;
+	dp->d_stop = 1;
+	for (k=0; k<nelem; k++) {
+		if ((dset[k>>4] & (1<<(k&017))) == 0)
+			continue;
+		dp->d_stop = 0;
+		ep = epos[k];
+		if (*ep == CEOF)
+			dp->d_acc = 1;
+		if (*ep == CDOL && dp->d_acc == 0)
+			dp->d_acc = 2;
+	}
+	if (dp->d_acc == 1)
+		dp->d_stop = 1;
+	for (k=0; k<NSET; k++)
+		dp->d_set[k] = dset[k];
+	for (k=0; k<256; k++)
+		dp->d_next[k] = 0;
+	return(nstate++);
+}
+
 cclass(aset, ac, af)
 {
 	register char *set, c;
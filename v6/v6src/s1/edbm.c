@@ -0,0 +1,141 @@
+#
+
+/*
+ *	edbm - time ed takes over global
+ *	and substitute commands on a large file
+ */
+
+char	*in	"/usr/tmp/ebmi";
+char	*scr	"/usr/tmp/ebms";
+int	nline	4000;
+char	*cmds[] {
+	"g/fox/s//FOX/g",
+	"1,$s/the/THE/g",
+	"g/^q/s/k/K/",
+	"g/l[a-z]*y/s/y$/Y/",
+	"g/a.*e/d",
+	"v/dog/d",
+	0
+};
+char	*words[] {
+	"the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog",
+	"alpha", "beta", "gamma", "delta", "sort", "grep", "file", "line"
+};
+
+int	obuf[259];
+
+main(argc, argv)
+char **argv;
+{
+	register i;
+
+	if (argc > 1)
+		nline = atoi(argv[1]);
+	if (nline <= 0) {
+		printf("Bad size\n");
+		exit(1);
+	}
+	gen();
+	printf("%d lines\n", nline);
+	printf("command                 user    sys\n");
+	if (argc > 2)
+		for (i=2; i<argc; i++)
+			bench(argv[i]);
+	else
+		for (i=0; cmds[i]; i++)
+			bench(cmds[i]);
+	unlink(in);
+	unlink(scr);
+	unlink("/usr/tmp/ebmo");
+}
+
+/*
+ * nline lines of two to seven words.
+ */
+gen()
+{
+	register i, j;
+
+	create(in);
+	for (i=0; i<nline; i++)
+		for (j = rand()%6+2; j > 0; j--) {
+			put(words[rand()%16]);
+			putc(j>1? ' ': '\n', obuf);
+		}
+	fflush(obuf);
+	close(obuf[0]);
+}
+
+/*
+ * Run the command under ed, writing the
+ * result aside so the input is kept.
+ * Ed quits with no status to test.
+ */
+bench(cmd)
+char *cmd;
+{
+	double ticks(), u, s;
+	int obt[6], tbuf[6], pid, status;
+
+	create(scr);
+	put(cmd);
+	put("\nw /usr/tmp/ebmo\nq\n");
+	fflush(obuf);
+	close(obuf[0]);
+	times(obt);
+	if ((pid = fork()) == 0) {
+		close(0);
+		open(scr, 0);
+		execl("/bin/ed", "ed", "-", in, 0);
+		printf("Can't find /bin/ed\n");
+		exit(1);
+	}
+	if (pid == -1) {
+		printf("Try again\n");
+		exit(1);
+	}
+	while (wait(&status) != pid);
+	times(tbuf);
+	u = (ticks(&tbuf[2])-ticks(&obt[2]))/60.;
+	s = (ticks(&tbuf[4])-ticks(&obt[4]))/60.;
+	printf("%-20s %7.1f%7.1f\n", cmd, u, s);
+}
+
+create(f)
+char *f;
+{
+	if (fcreat(f, obuf) < 0) {
+		printf("Can't create %s\n", f);
+		exit(1);
+	}
+}
+
+put(s)
+char *s;
+{
+	while (*s)
+		putc(*s++, obuf);
+}
+
+/*
+ * Child times are long.
+ */
+double
+ticks(p)
+int *p;
+{
+	double un();
+
+	return(un(p[0])*65536. + un(p[1]));
+}
+
+double
+un(a)
+{
+	double d;
+
+	d = a;
+	if (a < 0)
+		d =+ 65536.;
+	return(d);
+}
@@ -32,10 +32,30 @@ struct ibuf {
 	int	imtime[2];
 } statb;
 
+struct dir {
+	int	dinode;
+	char	dname[14];
+};
+#define	DCHUNK	2048
+char	*dlist;		/* directories being walked, each read whole */
+int	dlen, dmax;	/* bytes of dlist used and got */
+int	cdev;		/* device of the directory being read */
+char	aname[256];	/* the current pathname */
+char	home[128];	/* where find was started */
+int	needhome;
+
+#define	NARGC	510	/* bytes of arguments exec takes */
+char	xbuf[NARGC];	/* pathnames saved for -exec ... {} + */
+char	*xargv[NARGC/2];
+int	xn, xlen, xfix;
+struct anode *xnode;	/* the -exec they are for */
+int	xstat;
+
 main(argc,argv) char *argv[]; {
 
 struct anode *exlist;
 int find();
+int i;
 
 	time(&now);
 	ac = argc; av = argv; ap = 2;
@@ -58,7 +78,22 @@ int find();
 		printf("Missing conjunction\n");
 		exit(9);
 	}
-	descend(pathname,'f',find,exlist); /* to find files that match  */
+	if(pathname[0]!='/' || needhome) {
+		gethome();
+		if(home[0]==0) {
+			printf("Cannot find current directory\n");
+			exit(9);
+		}
+	}
+	dlist = sbrk(0);
+	for(i=0; aname[i]=pathname[i]; i++)
+		if(i >= sizeof aname - 16) {
+			printf("Pathname too long\n");
+			exit(9);
+		}
+	descend(aname,'f',find,exlist); /* to find files that match  */
+	xflush();
+	exit(xstat);
 }
 
 /* compile time functions:  priority is  exp()<e1()<e2()<e3()  */
@@ -101,9 +136,10 @@ struct anode *e2() { /* parse not (!) */
 	return(e3());
 }
 struct anode *e3() { /* parse parens and predicates */
-	int exeq(), ok(), glob(),  mtime(), atime(), user(),
+	int exeq(), exbat(), ok(), glob(),  mtime(), atime(), user(),
 		group(), size(), perm(), links(), print(),
 		type();
+	char *which();
 	int p1, i;
 	char *a, *b, s;
 	a = nxtarg();
@@ -155,14 +191,24 @@ struct anode *e3() { /* parse parens and predicates */
 		return(mk(&type,i,0));
 	}
 	else if (compstr(a,"-exec")==0) {
+		needhome++;
 		i = ap - 1;
-		while(compstr(nxtarg(),";")!=0);
-		return(mk(&exeq,i,0));
+		a = "";
+		while(compstr(b=nxtarg(),";")!=0) {
+			if(*b==0) goto err;
+			/* {} + runs the command on many files at once */
+			if(compstr(b,"+")==0 && compstr(a,"{}")==0)
+				return(mk(&exbat,i,which(av[i])));
+			a = b;
+		}
+		return(mk(&exeq,i,which(av[i])));
 	}
 	else if (compstr(a,"-ok")==0) {
+		needhome++;
 		i = ap - 1;
-		while(compstr(nxtarg(),";")!=0);
-		return(mk(&ok,i,0));
+		while(compstr(b=nxtarg(),";")!=0)
+			if(*b==0) goto err;
+		return(mk(&ok,i,which(av[i])));
 	}
 	err: printf("Bad option: \"%s\" \"%s\"\n",a,b);
 	exit(9);
@@ -240,16 +286,41 @@ int i;
 type(p) struct { int f, per, s; } *p; {
 	return((statb.iflags&060000)==p->per);
 }
-exeq(p) struct { int f, com; } *p; {
-	return(doex(p->com));
+exeq(p) struct { int f, com; char *cmd; } *p; {
+	return(doex(p->com, p->cmd));
+}
+exbat(p) struct { int f, com; char *cmd; } *p; {
+	register char *s, *t;
+	register int n;
+
+	if(xnode != p) {
+		xflush();
+		xnode = p;
+		xfix = 0;
+		for(n=p->com; compstr(av[n],"{}")!=0 || compstr(av[n+1],"+")!=0; n++)
+			for(s=av[n]; xfix++, *s++; );
+	}
+	for(n=1, s=path; *s++; n++);
+	if(xn && (xfix+xlen+n > NARGC || xn >= NARGC/2-50))
+		xflush();
+	if(xfix+n > NARGC) {	/* too long for exec anyway */
+		printf("--too long for exec %s\n",path);
+		xstat = 1;
+		return(1);
+	}
+	t = &xbuf[xlen];
+	xargv[xn++] = t;
+	for(s=path; *t++ = *s++; );
+	xlen =+ n;
+	return(1);
 }
-ok(p) struct { int f, com; } *p; {
+ok(p) struct { int f, com; char *cmd; } *p; {
 	char c;  int yes;
 	yes = 0;
 	printf("%s ... %s ...? ",av[p->com],path);
 	if((c=getchar())=='y') yes = 1;
 	while(c!='\n') c = getchar();
-	if(yes) return(doex(p->com));
+	if(yes) return(doex(p->com, p->cmd));
 	return(0);
 }
 
@@ -261,33 +332,95 @@ scomp(a,b,s) char s; { /* funny signed compare */
 		return(a < (b * -1));
 	return(a == b);
 }
-doex(com) {
-	int ccode;
-	int np, i, c;
-	char *nargv[50], *ncom, *na;
+doex(com, cmd) char *cmd; {
+	int np;
+	char *nargv[50], *na;
 
-	ccode = np = 0;
+	np = 0;
 	while (na=av[com++]) {
 		if(compstr(na,";")==0) break;
+		if(np >= 49) return(0);
 		if(compstr(na,"{}")==0) nargv[np++] = path;
 		else nargv[np++] = na;
 	}
 	nargv[np] = 0;
 	if (np==0) return(9);
-	if(fork()) /*parent*/ wait(&ccode);
-	else { /*child*/
-		execv(nargv[0], nargv, np);
-		i = 0;
-		ncom = "/usr/bin/xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx";
-		while(c=nargv[0][i])  {
-			ncom[9+i++] = c;
-		}
-		ncom[9+i] = '\0';
-		execv(ncom+4, nargv, np);
-		execv(ncom, nargv, np);
+	return(run(cmd, nargv) ? 0:1);
+}
+
+/*
+ * Run the saved pathnames through their
+ * -exec ... {} + all at once.
+ */
+xflush() {
+	struct { int f, com; char *cmd; } *p;
+	char *nargv[NARGC/2];
+	register int np, i;
+
+	if(xn == 0)
+		return;
+	p = xnode;
+	np = 0;
+	for(i=p->com; compstr(av[i],"{}")!=0 || compstr(av[i+1],"+")!=0; i++)
+		if(np < 49)
+			nargv[np++] = av[i];
+	for(i=0; i<xn; i++)
+		nargv[np++] = xargv[i];
+	nargv[np] = 0;
+	if(run(p->cmd, nargv))
+		xstat = 1;
+	xn = 0;
+	xlen = 0;
+}
+
+/*
+ * Run cmd with args in the directory find
+ * was started in; return its exit status.
+ */
+run(cmd, args) char *cmd, **args; {
+	int ccode, pid, w;
+
+	ccode = 0;
+	if((pid = fork()) == 0) {
+		chdir(home);
+		execv(cmd, args);
 		exit(9);
 	}
-	return(ccode ? 0:1);
+	if(pid == -1)
+		return(9);
+	while((w = wait(&ccode)) != pid && w != -1);
+	return(ccode);
+}
+
+/*
+ * Find once the file a command name stands for:
+ * the name itself, or the name in /bin or /usr/bin.
+ */
+char *which(name) char *name; {
+	register char *p, *q, *d;
+	int i;
+
+	for(p=name; *p; p++)
+		if(*p=='/')
+			return(name);
+	if(isexec(name))
+		return(name);
+	if((q = sbrk(((p-name)+11) & ~01)) == -1)
+		return(name);
+	for(i=0; i<2; i++) {
+		p = q;
+		for(d = i? "/usr/bin/": "/bin/"; *p = *d++; p++);
+		for(d=name; *p++ = *d++; );
+		if(isexec(q))
+			return(q);
+	}
+	return(name);
+}
+
+isexec(s) char *s; {
+	if(stat(s,&statb) < 0)
+		return(0);
+	return((statb.iflags&060000)==0 && (statb.iflags&0111)!=0);
 }
 
 char fin[518];
@@ -329,21 +462,26 @@ register char *c1, *c2;
 	return(*c1 > *c2 ? 1 : -1);
 }
 
+/*
+ * Walk the tree by going into each directory
+ * and looking at its entries by their own names,
+ * so the system need not look up the whole pathname
+ * for each file.  name is the last part of aname
+ * (or all of it, to start) and is looked up from
+ * the directory find is in.
+ */
 int descend(name,goal,func,arg)
 int (*func)();
 char *name, goal;
 {
-	int dir /* open directory */, offset /* in directory */;
-	int dsize, top;
-	struct {
-		int	dinode;
-		char	dname[14];
-	} dentry[32];
-	register int i, j, k;
-	char aname[128];
+	register struct dir *dp;
+	register int j, k;
+	struct dir *top;
+	int dir, end, save, dev, pdev, ret;
 
+	pdev = cdev;
 	if(stat(name,&statb)<0) {
-		printf("--bad status %s\n",name);
+		printf("--bad status %s\n",aname);
 		return(0);
 	}
 /*
@@ -357,39 +495,117 @@ char *name, goal;
 /*
 			(*func)(arg,name);
 */
-	(*func)(arg,name);
+	(*func)(arg,aname);
 	if((statb.iflags&060000)!=040000)
 		return(1);
 
-	top = statb.isize;
-	for(offset=0 ; offset < top ; offset =+ 512) { /* each block */
-		dsize = 512<(top-offset) ? 512 : (top-offset);
-		if((dir=open(name,0))<0) {
-			printf("--cannot open %s\n",name);
-			return(0);
+	dev = statb.idev;
+	if(chdir(name)<0) {
+		printf("--cannot open %s\n",aname);
+		return(0);
+	}
+	ret = 1;
+	save = dlen;
+	if((dir=open(".",0))<0) {
+		printf("--cannot open %s\n",aname);
+		ret = 0;
+		goto out;
+	}
+	/* read it all at once, above the directories above it */
+	for(;;) {
+		if(dmax-dlen < 512) {
+			if(sbrk(DCHUNK) == -1) {
+				printf("--no room for %s\n",aname);
+				ret = 0;
+				break;
+			}
+			dmax =+ DCHUNK;
 		}
-		if(offset) seek(dir,offset,0);
-		if(read(dir,&dentry,dsize)<0) {
-			printf("--cannot read %s\n",name);
-			return(0);
+		if((j=read(dir,dlist+dlen,(dmax-dlen)&~0777)) <= 0) {
+			if(j<0) {
+				printf("--cannot read %s\n",aname);
+				ret = 0;
+			}
+			break;
 		}
-		close(dir);
-		for(i = 0; i < (dsize>>4); ++i) { /* each dir. entry */
-			if(dentry[i].dinode==0 ||
-				compstr(dentry[i].dname,".")==0 ||
-				compstr(dentry[i].dname,"..")==0)
-				continue;
-			if (dentry[i].dinode == -1) break;
-			for(j=0;aname[j]=name[j];++j);
-			if(aname[j-1]!='/') aname[j++] = '/';
-			for(k=0; (aname[j++]=dentry[i].dname[k]) &&
-				k<13; ++k);
-			aname[j] = '\0';
-			if(descend(aname,goal,func,arg)==0)
-				printf("--%s\n",name);
+		dlen =+ j;
+	}
+	close(dir);
+	for(end=0; aname[end]; end++);
+	top = dlist+dlen;
+	for(dp = dlist+save; dp < top; ++dp) { /* each dir. entry */
+		if(dp->dinode==0 ||
+			compstr(dp->dname,".")==0 ||
+			compstr(dp->dname,"..")==0)
+			continue;
+		if (dp->dinode == -1) break;
+		if(end+16 > sizeof aname) {
+			printf("--name too long in %s\n",aname);
+			continue;
 		}
+		j = end;
+		if(aname[j-1]!='/') aname[j++] = '/';
+		k = j;
+		while(j < k+14 && (aname[j]=dp->dname[j-k]))
+			j++;
+		aname[j] = '\0';
+		cdev = dev;
+		j = descend(&aname[k],goal,func,arg);
+		aname[end] = '\0';
+		if(j==0)
+			printf("--%s\n",aname);
 	}
-	return(1);
+out:
+	dlen = save;
+	if(name == aname)
+		return(ret);
+	/*
+	 * ".." in the root of a mounted file system
+	 * is the root itself; from there, go back
+	 * by the parent's whole name.
+	 */
+	if(dev==pdev && chdir("..")==0)
+		return(ret);
+	if((j = name-aname-1) == 0)
+		j = 1;
+	k = aname[j];
+	aname[j] = '\0';
+	if(aname[0]!='/' && chdir(home)<0 || chdir(aname)<0) {
+		printf("--cannot return to %s\n",aname);
+		exit(9);
+	}
+	aname[j] = k;
+	return(ret);
+}
+
+/*
+ * Get the name of the current directory from pwd.
+ */
+gethome()
+{
+	int pv[2], n, i;
+
+	if(pipe(pv) < 0)
+		return;
+	if((i = fork()) == 0) {
+		close(1);
+		dup(pv[1]);
+		close(pv[0]);
+		close(pv[1]);
+		execl("/bin/pwd", "pwd", 0);
+		exit(9);
+	}
+	close(pv[1]);
+	n = 0;
+	if(i != -1)
+		while(n < sizeof home && (i=read(pv[0],home+n,sizeof home-n)) > 0)
+			n =+ i;
+	close(pv[0]);
+	wait(&i);
+	if(n > 1 && n < sizeof home && home[n-1]=='\n')
+		home[n-1] = '\0';
+	else
+		home[0] = '\0';
 }
 
 gmatch(s, p) /* string match as in glob */
@@ -0,0 +1,108 @@
+#
+
+/*
+ *	findbm - system calls, lookups and blocks
+ *	find costs in walking a tree
+ */
+
+char	*dflt[]	{ "find", "/", "-print", 0 };
+
+struct {
+	char name[8];
+	int  type;
+	char  *value;
+} nl[2];
+
+struct sysstat {
+	int	ss_bread;
+	int	ss_bhit;
+	int	ss_read;
+	int	ss_write;
+	int	ss_iget;
+	int	ss_ihit;
+	int	ss_namei;
+	int	ss_dirent;
+	int	ss_syscall;
+	int	ss_stime;
+} old, new;
+
+int	mem;
+
+main(argc, argv)
+char **argv;
+{
+	double un(), ticks();
+	int obt[6], tbuf[6], pid, status;
+
+	setup(&nl[0], "_sysstat");
+	nlist("/unix", nl);
+	if (nl[0].type==0) {
+		printf("No namelist\n");
+		exit(1);
+	}
+	if ((mem = open("/dev/mem", 0)) < 0) {
+		printf("No mem\n");
+		exit(1);
+	}
+	argv[0] = "find";
+	if (argc < 2)
+		argv = dflt;
+	times(obt);
+	seek(mem, nl[0].value, 0);
+	read(mem, &old, sizeof old);
+	if ((pid = fork()) == 0) {
+		close(1);
+		open("/dev/null", 1);
+		execv("/usr/bin/find", argv);
+		exit(1);
+	}
+	if (pid == -1) {
+		printf("Try again\n");
+		exit(1);
+	}
+	while (wait(&status) != pid);
+	seek(mem, nl[0].value, 0);
+	read(mem, &new, sizeof new);
+	times(tbuf);
+	printf("  sysc namei dirent bread  read  iget   user    sys\n");
+	printf("%6.0f", un(new.ss_syscall-old.ss_syscall));
+	printf("%6.0f", un(new.ss_namei-old.ss_namei));
+	printf("%7.0f", un(new.ss_dirent-old.ss_dirent));
+	printf("%6.0f", un(new.ss_bread-old.ss_bread));
+	printf("%6.0f", un(new.ss_read-old.ss_read));
+	printf("%6.0f", un(new.ss_iget-old.ss_iget));
+	printf("%7.1f", (ticks(&tbuf[2])-ticks(&obt[2]))/60.);
+	printf("%7.1f\n", (ticks(&tbuf[4])-ticks(&obt[4]))/60.);
+}
+
+/*
+ * Child times are long.
+ */
+double
+ticks(p)
+int *p;
+{
+	double un();
+
+	return(un(p[0])*65536. + un(p[1]));
+}
+
+/*
+ * The counts are unsigned.
+ */
+double
+un(a)
+{
+	double d;
+
+	d = a;
+	if (a < 0)
+		d =+ 65536.;
+	return(d);
+}
+
+setup(p, s)
+char *p, *s;
+{
+	while (*p++ = *s++);
+}
@@ -2,6 +2,16 @@
 /*
  * grep -- print lines matching (or not matching) a pattern
  *
+ * The compiled expression is run as a DFA, whose states
+ * (sets of positions in the expression) are made as the
+ * input needs them.  If the expression requires a string
+ * of two or more characters, a Boyer-Moore search for it
+ * runs over the whole buffer, and only the lines where
+ * it is found are given to the DFA.
+ *
+ * Input is read in large pieces and matched where it lies;
+ * lines may be of any length.  Lines are counted only
+ * as far as -n needs.
  */
 
 #define	CCHR	2
@@ -13,22 +23,39 @@
 
 #define	STAR	01
 
-#define	LBSIZE	256
+#define	BSIZE	8192
 #define	ESIZE	256
+#define	NSTATE	32
+#define	NSET	16		/* words in a set of positions */
 
-char	ibuf[512];
+char	*ibuf;
+int	ibsize;
 char	expbuf[ESIZE];
-int	lnum[2];
-char	linebuf[LBSIZE+1];
+int	lnum[2];		/* lines before lcp */
+char	*lcp;
+int	foff[2];		/* file offset of ibuf */
 int	bflag;
 int	nflag;
 int	cflag;
 int	vflag;
 int	nfile;
 int	circf;
-int	blkno;
 int	tln[2];
 
+char	*epos[ESIZE];		/* each element of expbuf */
+int	nelem;
+struct	dstate {
+	int	d_set[NSET];	/* positions reached */
+	int	d_acc;		/* 1 matched, 2 matched at end of line */
+	int	d_stop;		/* matched, or no positions left */
+	char	d_next[256];	/* next state+1 on each character */
+} dstate[NSTATE];
+int	nstate;
+int	dset[NSET];
+char	litp[ESIZE/2];	/* the longest required string */
+int	litn;
+char	litskip[256];
+
 main(argc, argv)
 char **argv;
 {
@@ -62,6 +89,9 @@ char **argv;
 	if (argc<=0)
 		exit(2);
 	compile(*argv);
+	dfainit();
+	ibuf = sbrk(BSIZE);
+	ibsize = BSIZE;
 	nfile = --argc;
 	if (argc<=0)
 		execute(0);
@@ -146,10 +176,9 @@ char *astr;
 
 execute(file)
 {
-	register char *p1, *p2;
-	register c;
-	int f;
-	char *ebp, *cbp;
+	register char *p, *q, *e;
+	int f, n;
+	char *lp;
 
 	if (file) {
 		if ((f = open(file, 0)) < 0) {
@@ -157,147 +186,366 @@ execute(file)
 		}
 	} else
 		f = 0;
-	ebp = ibuf;
-	cbp = ibuf;
 	lnum[0] = 0;
 	lnum[1] = 0;
+	foff[0] = 0;
+	foff[1] = 0;
 	tln[0] = 0;
 	tln[1] = 0;
-	blkno = -1;
+	lp = ibuf;
+	e = ibuf;
 	for (;;) {
-		if ((++lnum[1])==0)
-			lnum[1]++;
-		if((lnum[1]&0377) == 0)
-			flush();
-		p1 = linebuf;
-		p2 = cbp;
-		for (;;) {
-			if (p2 >= ebp) {
-				if ((c = read(f, ibuf, 512)) <= 0) {
-					close(f);
-					if (cflag) {
-						if (nfile > 1)
-							printf("%s:", file);
-						p1 = locv(tln[0],tln[1]);
-						printf("%s\n", p1);
-					}
-					return;
-				}
-				blkno++;
-				p2 = ibuf;
-				ebp = ibuf+c;
-			}
-			if ((c = *p2++) == '\n')
-				break;
-			if(c)
-			if (p1 < &linebuf[LBSIZE-1])
-				*p1++ = c;
+		/* move the partial line to the front */
+		if (lp > ibuf) {
+			if (nflag)
+				lcount(lp);
+			ladd(foff, lp-ibuf);
+			p = ibuf;
+			for (q = lp; q < e; )
+				*p++ = *q++;
+			e = p;
+			lp = ibuf;
 		}
-		*p1++ = 0;
-		cbp = p2;
-		p1 = linebuf;
-		p2 = expbuf;
-		if (circf) {
-			if (advance(p1, p2))
-				goto found;
-			goto nfound;
+		lcp = ibuf;
+		if (e+512 > ibuf+ibsize) {
+			/* by BSIZE, lest sbrk see ibsize go negative */
+			if (sbrk(BSIZE) == -1)
+				printf2("Line too long\n");
+			ibsize =+ BSIZE;
 		}
-		/* fast check for first character */
-		if (*p2==CCHR) {
-			c = p2[1];
-			do {
-				if (*p1!=c)
-					continue;
-				if (advance(p1, p2))
-					goto found;
-			} while (*p1++);
-			goto nfound;
+		n = read(f, e, (ibuf+ibsize-e) & ~0777);
+		if (n <= 0)
+			break;
+		/* null characters are ignored */
+		p = e;
+		e =+ n;
+		while (p < e && *p)
+			p++;
+		for (q = p; p < e; p++)
+			if (*p)
+				*q++ = *p;
+		e = q;
+		for (p = e; p > lp && p[-1] != '\n'; p--)
+			;
+		if (p > lp) {
+			if (litn && vflag == 0)
+				lscan(lp, p, file);
+			else
+				dscan(lp, p, file);
+			lp = p;
 		}
-		/* regular algorithm */
-		do {
-			if (advance(p1, p2))
-				goto found;
-		} while (*p1++);
-	nfound:
-		if (vflag)
-			succeed(file);
-		continue;
-	found:
-		if (vflag==0)
-			succeed(file);
+		flush();
+	}
+	close(f);
+	if (cflag) {
+		if (nfile > 1)
+			printf("%s:", file);
+		p = locv(tln[0],tln[1]);
+		printf("%s\n", p);
 	}
 }
 
-advance(alp, aep)
+/*
+ * Look for the required string in the
+ * whole lines from s to e, and give the
+ * lines it is in to the DFA.
+ */
+lscan(s, e, file)
+char *s, *e;
 {
-	register char *lp, *ep, *curlp;
-	char *nextep;
-
-	lp = alp;
-	ep = aep;
-	for (;;) switch (*ep++) {
+	register char *p, *q, *l;
+
+	p = s;
+	while (q = find(p, e)) {
+		for (l = q; l > p && l[-1] != '\n'; l--)
+			;
+		while (*q != '\n')
+			q++;
+		if (dmatch(l, q))
+			succeed(file, l, q);
+		p = q+1;
+	}
+}
 
-	case CCHR:
-		if (*ep++ == *lp++)
+/*
+ * Run the DFA over the whole lines from s to e,
+ * and report those that match, or with -v
+ * those that do not.
+ */
+dscan(s, e, file)
+char *s, *e;
+{
+	register char *p;
+	register struct dstate *dp;
+	register n;
+	char *l;
+
+	dp = dstate;
+	l = s;
+	for (p = s; p < e; p++) {
+		if (*p == '\n') {
+			if ((dp->d_acc != 0) != (vflag != 0))
+				succeed(file, l, p);
+			dp = dstate;
+			l = p+1;
 			continue;
-		return(0);
-
-	case CDOT:
-		if (*lp++)
+		}
+		if (dp->d_stop) {
+			while (p[1] != '\n')
+				p++;
 			continue;
-		return(0);
+		}
+		if ((n = dp->d_next[*p&0377]) == 0)
+			n = dnext(dp, *p&0377) + 1;
+		dp = &dstate[n-1];
+	}
+}
 
-	case CDOL:
-		if (*lp==0)
-			continue;
-		return(0);
+/*
+ * Count the lines from lcp to p.
+ */
+lcount(p)
+char *p;
+{
+	register char *q, *e;
+	register n;
+
+	n = 0;
+	e = p;
+	for (q = lcp; q < e; q++)
+		if (*q == '\n')
+			n++;
+	ladd(lnum, n);
+	lcp = e;
+}
+
+/*
+ * Add n, unsigned, to the long at l.
+ */
+ladd(l, n)
+int *l;
+{
+	register a;
 
-	case CEOF:
-		return(1);
+	a = l[1];
+	l[1] =+ n;
+	if (l[1]+0100000 < a+0100000)	/* unsigned compare */
+		l[0]++;
+}
 
-	case CCL:
-		if (cclass(ep, *lp++, 1)) {
-			ep =+ *ep;
+/*
+ * Find the elements of the expression
+ * and its longest run of plain characters,
+ * and make the start state.
+ */
+dfainit()
+{
+	register char *ep;
+	register n;
+	char *rp, *lp;
+
+	rp = 0;
+	lp = 0;
+	n = 0;
+	for (ep = expbuf; ; ) {
+		epos[nelem++] = ep;
+		if (*ep == CCHR) {
+			if (n++ == 0)
+				rp = ep;
+			if (n > litn) {
+				litn = n;
+				lp = rp;
+			}
+		} else
+			n = 0;
+		if (*ep == CEOF)
+			break;
+		switch (*ep & ~STAR) {
+		case CCHR:
+			ep =+ 2;
 			continue;
+		case CCL:
+		case NCCL:
+			ep =+ ep[1] + 1;
+			continue;
+		default:
+			ep++;
 		}
-		return(0);
+	}
+	dset[0] = 1;
+	closure();
+	newstate();
+	if (litn < 2) {
+		litn = 0;
+		return;
+	}
+	for (n=0; n<litn; n++)
+		litp[n] = lp[2*n+1];
+	for (n=0; n<256; n++)
+		litskip[n] = litn;
+	for (n=0; n<litn-1; n++)
+		litskip[litp[n]&0377] = litn-1-n;
+}
+
+/*
+ * Boyer-Moore-Horspool search for the required
+ * string in s up to e; returns where it ends.
+ */
+find(s, e)
+char *s, *e;
+{
+	register char *p, *q, *l;
+
+	for (p = s+litn-1; p < e; p =+ litskip[*p&0377]) {
+		q = p;
+		l = &litp[litn-1];
+		while (*q == *l) {
+			if (l == litp)
+				return(p);
+			q--;
+			l--;
+		}
+	}
+	return(0);
+}
+
+/*
+ * Run the DFA over the line from s to e.
+ */
+dmatch(s, e)
+char *s, *e;
+{
+	register char *p;
+	register struct dstate *dp;
+	register n;
+
+	dp = dstate;
+	for (p = s; p < e; p++) {
+		if (dp->d_stop)
+			return(dp->d_acc);
+		if ((n = dp->d_next[*p&0377]) == 0)
+			n = dnext(dp, *p&0377) + 1;
+		dp = &dstate[n-1];
+	}
+	return(dp->d_acc);
+}
+
+/*
+ * Make the state that dp goes to on c.
+ * If the table is full, it is emptied
+ * and refilled from the start state.
+ */
+dnext(dp, c)
+struct dstate *dp;
+{
+	register char *ep;
+	register i, k;
+	int s[NSET];
 
-	case NCCL:
-		if (cclass(ep, *lp++, 0)) {
-			ep =+ *ep;
+	for (i=0; i<NSET; i++) {
+		s[i] = dp->d_set[i];
+		dset[i] = 0;
+	}
+	for (k=0; k<nelem; k++) {
+		if ((s[k>>4] & (1<<(k&017))) == 0)
+			continue;
+		ep = epos[k];
+		switch (*ep & ~STAR) {
+		case CCHR:
+			if ((ep[1]&0377) != c)
+				continue;
+			break;
+		case CDOT:
+			break;
+		case CCL:
+			if (cclass(ep+1, c, 1))
+				break;
+			continue;
+		case NCCL:
+			if (cclass(ep+1, c, 0))
+				break;
+			continue;
+		default:
 			continue;
 		}
-		return(0);
+		if (*ep & STAR)
+			i = k; else
+			i = k+1;
+		dset[i>>4] =| 1<<(i&017);
+	}
+	if (circf == 0)
+		dset[0] =| 1;
+	closure();
+	for (i=0; i<nstate; i++) {
+		for (k=0; k<NSET; k++)
+			if (dstate[i].d_set[k] != dset[k])
+				goto no;
+		break;
+	no:;
+	}
+	if (i == nstate) {
+		if (nstate >= NSTATE) {
+			for (k=0; k<NSET; k++)
+				s[k] = dset[k];
+			for (k=0; k<NSET; k++)
+				dset[k] = 0;
+			dset[0] = 1;
+			closure();
+			nstate = 0;
+			newstate();
+			for (k=0; k<NSET; k++)
+				dset[k] = s[k];
+			return(newstate());
+		}
+		i = newstate();
+	}
+	dp->d_next[c] = i+1;
+	return(i);
+}
 
-	case CDOT|STAR:
-		curlp = lp;
-		while (*lp++);
-		goto star;
-
-	case CCHR|STAR:
-		curlp = lp;
-		while (*lp++ == *ep);
-		ep++;
-		goto star;
-
-	case CCL|STAR:
-	case NCCL|STAR:
-		curlp = lp;
-		while (cclass(ep, *lp++, ep[-1]==(CCL|STAR)));
-		ep =+ *ep;
-		goto star;
-
-	star:
-		do {
-			lp--;
-			if (advance(lp, ep))
-				return(1);
-		} while (lp > curlp);
-		return(0);
+/*
+ * Add to dset the elements after
+ * starred ones, which may match nothing.
+ */
+closure()
+{
+	register k;
+
+	for (k=0; k<nelem-1; k++)
+		if (dset[k>>4] & (1<<(k&017)))
+		if (*epos[k] & STAR)
+			dset[(k+1)>>4] =| 1<<((k+1)&017);
+}
 
-	default:
-		printf2("RE botch\n");
+/*
+ * Add the set in dset as a new state.
+ */
+newstate()
+{
+	register struct dstate *dp;
+	register char *ep;
+	register k;
+
+	dp = &dstate[nstate];
+	dp->d_acc = 0;
+	dp->d_stop = 1;
+	for (k=0; k<nelem; k++) {
+		if ((dset[k>>4] & (1<<(k&017))) == 0)
+			continue;
+		dp->d_stop = 0;
+		ep = epos[k];
+		if (*ep == CEOF)
+			dp->d_acc = 1;
+		if (*ep == CDOL && dp->d_acc == 0)
+			dp->d_acc = 2;
 	}
+	if (dp->d_acc == 1)
+		dp->d_stop = 1;
+	for (k=0; k<NSET; k++)
+		dp->d_set[k] = dset[k];
+	for (k=0; k<256; k++)
+		dp->d_next[k] = 0;
+	return(nstate++);
 }
 
 cclass(aset, ac, af)
@@ -325,8 +573,14 @@ printf2(s, a)
 	exit(2);
 }
 
-succeed(f)
+/*
+ * Print the line from l to its newline at e.
+ */
+succeed(f, l, e)
+char *l, *e;
 {
+	int b[2];
+
 	if (cflag) {
 		if (++tln[1]==0)
 			tln[0]++;
@@ -334,9 +588,20 @@ succeed(f)
 	}
 	if (nfile > 1)
 		printf("%s:", f);
-	if (bflag)
-		printf("%l:", blkno);
-	if (nflag)
-		printf("%s:", locv(lnum[0], lnum[1]));
-	printf("%s\n", linebuf);
+	if (bflag) {
+		b[0] = foff[0];
+		b[1] = foff[1];
+		ladd(b, e-ibuf);
+		printf("%l:", ldiv(b[0], b[1], 512));
+	}
+	if (nflag) {
+		lcount(l);
+		b[0] = lnum[0];
+		b[1] = lnum[1];
+		ladd(b, 1);
+		printf("%s:", locv(b[0], b[1]));
+	}
+	*e = 0;
+	printf("%s\n", l);
+	*e = '\n';
 }
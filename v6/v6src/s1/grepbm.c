@@ -0,0 +1,136 @@
+#
+
+/*
+ *	grepbm - rate at which grep gets through
+ *	a file for patterns of several kinds
+ */
+
+char	*in	"/usr/tmp/gbmi";
+int	nblk	200;
+char	*pats[] {
+	"the",
+	"zqzq",
+	"a.*b.*c",
+	"[a-z]*q",
+	"^x.*y$",
+	"[^a-m]*z$",
+	0
+};
+
+int	obuf[259];
+int	nc, nb;
+
+main(argc, argv)
+char **argv;
+{
+	register i;
+
+	if (argc > 1)
+		nblk = atoi(argv[1]);
+	if (nblk <= 0) {
+		printf("Bad size\n");
+		exit(1);
+	}
+	gen();
+	printf("%d blocks\n", nblk);
+	printf("pattern           user    sys   K/sec\n");
+	if (argc > 2)
+		for (i=2; i<argc; i++)
+			bench(argv[i]);
+	else
+		for (i=0; pats[i]; i++)
+			bench(pats[i]);
+	unlink(in);
+}
+
+/*
+ * nblk blocks of lines of random words,
+ * ten to seventy characters a line.
+ */
+gen()
+{
+	register i, j;
+
+	if (fcreat(in, obuf) < 0) {
+		printf("Can't create %s\n", in);
+		exit(1);
+	}
+	nc = nb = 0;
+	while (nb < nblk) {
+		j = rand()%61 + 10;
+		for (i=0; i<j; i++)
+			put(rand()%5==0? ' ': 'a'+rand()%26);
+		put('\n');
+	}
+	fflush(obuf);
+	close(obuf[0]);
+}
+
+put(c)
+{
+	putc(c, obuf);
+	if (++nc >= 512) {
+		nc = 0;
+		nb++;
+	}
+}
+
+/*
+ * The rate is of user and system time
+ * together; K/sec, as a megabyte
+ * a second is out of reach here.
+ */
+bench(pat)
+char *pat;
+{
+	double ticks(), u, s;
+	int obt[6], tbuf[6], pid, status;
+
+	times(obt);
+	if ((pid = fork()) == 0) {
+		close(1);
+		open("/dev/null", 1);
+		execl("/usr/bin/grep", "grep", "-c", pat, in, 0);
+		exit(1);
+	}
+	if (pid == -1) {
+		printf("Try again\n");
+		exit(1);
+	}
+	while (wait(&status) != pid);
+	times(tbuf);
+	if (status) {
+		printf("%-14s grep failed\n", pat);
+		return;
+	}
+	u = (ticks(&tbuf[2])-ticks(&obt[2]))/60.;
+	s = (ticks(&tbuf[4])-ticks(&obt[4]))/60.;
+	printf("%-14s %7.1f%7.1f", pat, u, s);
+	if (u+s > 0.)
+		printf("%8.1f\n", nblk/2./(u+s));
+	else
+		printf("       -\n");
+}
+
+/*
+ * Child times are long.
+ */
+double
+ticks(p)
+int *p;
+{
+	double un();
+
+	return(un(p[0])*65536. + un(p[1]));
+}
+
+double
+un(a)
+{
+	double d;
+
+	d = a;
+	if (a < 0)
+		d =+ 65536.;
+	return(d);
+}
@@ -0,0 +1,185 @@
+#
+
+/*
+ *	iostat - report buffer cache and file system activity
+ *	from the counts in the system's sysstat,
+ *	and disk activity from rpstat and hpstat
+ */
+
+struct {
+	char name[8];
+	int  type;
+	char  *value;
+} nl[4];
+
+struct sysstat {
+	int	ss_bread;
+	int	ss_bhit;
+	int	ss_read;
+	int	ss_write;
+	int	ss_iget;
+	int	ss_ihit;
+	int	ss_namei;
+	int	ss_dirent;
+	int	ss_syscall;
+	int	ss_stime;
+	int	ss_age[4];
+} old, new;
+
+struct dstat {
+	int	ds_seek;
+	int	ds_xfer;
+	int	ds_blk;
+} odk[2][8], ndk[2][8];
+char	*dkname[] { "rp", "hp" };
+
+int	mem;
+
+main(argc, argv)
+char **argv;
+{
+	int n, i;
+
+	n = 0;
+	if (argc>1)
+		n = atoi(argv[1]);
+	setup(&nl[0], "_sysstat");
+	setup(&nl[1], "_rpstat");
+	setup(&nl[2], "_hpstat");
+	nlist(argc>2? argv[2]:"/unix", nl);
+	if (nl[0].type==0) {
+		printf("No namelist\n");
+		exit(1);
+	}
+	if ((mem = open("/dev/mem", 0)) < 0) {
+		printf("No mem\n");
+		exit(1);
+	}
+	for (i=0;; i++) {
+		if (i%20 == 0)
+	printf(" bread  hit%%  read write  iget  hit%% namei dirent  sysc  ms/call\n");
+		seek(mem, nl[0].value, 0);
+		read(mem, &new, sizeof new);
+		prstat();
+		prage();
+		prdisk();
+		if (n <= 0)
+			exit(0);
+		copy(&new, &old, sizeof new);
+		copy(ndk, odk, sizeof ndk);
+		sleep(n);
+	}
+}
+
+/*
+ * Print the counts accumulated since
+ * the last call, or since boot the first time.
+ */
+prstat()
+{
+	double un(), pct();
+	double b, r, s;
+
+	b = un(new.ss_bread-old.ss_bread);
+	printf("%6.0f", b);
+	printf("%6.1f", pct(new.ss_bhit-old.ss_bhit, b));
+	printf("%6.0f", un(new.ss_read-old.ss_read));
+	printf("%6.0f", un(new.ss_write-old.ss_write));
+	r = un(new.ss_iget-old.ss_iget);
+	printf("%6.0f", r);
+	printf("%6.1f", pct(new.ss_ihit-old.ss_ihit, r));
+	printf("%6.0f", un(new.ss_namei-old.ss_namei));
+	printf("%7.0f", un(new.ss_dirent-old.ss_dirent));
+	s = un(new.ss_syscall-old.ss_syscall);
+	printf("%6.0f", s);
+	if (s == 0)
+		s = 1;
+	printf("%9.3f\n", un(new.ss_stime-old.ss_stime)*1000./60./s);
+}
+
+/*
+ * Print how many clock ticks aged
+ * 1, 2-3, 4-15 and 16 or more proc
+ * entries, if any did.
+ */
+prage()
+{
+	double un();
+	register i;
+
+	for (i=0; i<4; i++)
+		if (new.ss_age[i] != old.ss_age[i])
+			break;
+	if (i == 4)
+		return;
+	printf("    age");
+	for (i=0; i<4; i++)
+		printf("%7.0f", un(new.ss_age[i]-old.ss_age[i]));
+	printf("\n");
+}
+
+/*
+ * Print a line for each drive
+ * which has done anything.
+ */
+prdisk()
+{
+	double un();
+	register struct dstat *o, *p;
+	int c, d;
+
+	for (c=0; c<2; c++) {
+		if (nl[c+1].type==0)
+			continue;
+		seek(mem, nl[c+1].value, 0);
+		read(mem, ndk[c], sizeof ndk[c]);
+		for (d=0; d<8; d++) {
+			p = &ndk[c][d];
+			o = &odk[c][d];
+			if (p->ds_xfer==o->ds_xfer && p->ds_seek==o->ds_seek)
+				continue;
+			printf("    %s%d", dkname[c], d);
+			printf(" seeks%6.0f", un(p->ds_seek-o->ds_seek));
+			printf(" xfers%6.0f", un(p->ds_xfer-o->ds_xfer));
+			printf(" blocks%7.0f\n", un(p->ds_blk-o->ds_blk));
+		}
+	}
+}
+
+double
+pct(a, b)
+double b;
+{
+	double un();
+
+	if (b == 0)
+		return(0.);
+	return(100.*un(a)/b);
+}
+
+/*
+ * The counts are unsigned.
+ */
+double
+un(a)
+{
+	double d;
+
+	d = a;
+	if (a < 0)
+		d =+ 65536.;
+	return(d);
+}
+
+copy(f, t, n)
+char *f, *t;
+{
+	while (n--)
+		*t++ = *f++;
+}
+
+setup(p, s)
+char *p, *s;
+{
+	while (*p++ = *s++);
+}
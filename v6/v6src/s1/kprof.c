@@ -0,0 +1,249 @@
+/*
+ *  Print kernel execution profile
+ *  gathered by /dev/kprof
+ */
+
+struct nl {
+	char name[8];
+	int value;
+	float time;
+};
+
+struct nl nl[600];
+
+struct fnl {
+	char fname[8];
+	int flag;
+	int fvalue;
+};
+
+struct {
+	char name[8];
+	int type;
+	int value;
+} nlx[2];
+
+int	ibuf[259];
+int	obuf[259];
+int	buf[17];
+int	hist[1024];
+int	ctl[2];
+int	i;
+int	j;
+int	highpc;
+int	lowpc;
+int	ccnt;
+int	pcl;
+int	pch;
+int	bufs;
+int	nname;
+double	time;
+double	totime;
+double	scale;
+struct nl *np;
+struct nl *npe;
+int	aflg;
+int	bflg;
+int	eflg;
+int	lflg;
+int	symoff;
+int	symsiz;
+
+main(argc, argv)
+char **argv;
+{
+	char *namfil, *proffil;
+	int timcmp(), valcmp();
+	int nf, pf, overlap, nfile;
+
+	obuf[0] = 1;
+	argv++;
+	namfil = "/unix";
+	proffil = "/dev/kprof";
+	nfile = 0;
+	while (argc>1) {
+		if (**argv == '-') {
+			if (*++*argv == 'l')
+				lflg++;
+			if (**argv == 'a')
+				aflg = 040;
+			if (**argv == 'b')
+				bflg++;
+			if (**argv == 'e')
+				eflg++;
+		} else if (nfile++ == 0)
+			namfil = *argv;
+		else
+			proffil = *argv;
+		argc--;
+		argv++;
+	}
+	if (bflg || eflg) {
+		ctl[0] = 0;
+		ctl[1] = 0;
+		if (bflg) {
+			setup(nlx[0].name, "_etext");
+			nlist(namfil, nlx);
+			if (nlx[0].type == 0) {
+				printf("No namelist: %s\n", namfil);
+				done();
+			}
+			ctl[1] = nlx[0].value;
+		}
+		if ((pf = open(proffil, 1)) < 0 || write(pf, ctl, 4) != 4) {
+			printf("Cannot write %s\n", proffil);
+			done();
+		}
+		done();
+	}
+	if ((nf = open(namfil, 0)) < 0) {
+		printf("Can't find %s\n", namfil);
+		done();
+	}
+	read(nf, buf, 020);
+	if (buf[0] != 0407 && buf[0] != 0410 && buf[0] != 0411) { /* a.out magic */
+		printf("Bad format: %s\n", namfil);
+		done();
+	}
+	symsiz = buf[4];
+	symoff = buf[1] + buf[2];
+	if (buf[7] != 1)
+		symoff =<< 1;
+	seek(nf, symoff+020, 0);
+	if ((pf = open(proffil, 0)) < 0) {
+		printf("Can't open %s\n", proffil);
+		done();
+	}
+	if (read(pf, buf, 6) != 6) {
+		printf("No profile: %s\n", proffil);
+		done();
+	}
+	lowpc = buf[0];
+	highpc = buf[1];
+	for (i=0; i<buf[2]; i++)
+		read(pf, buf, 6);
+	bufs = read(pf, hist, sizeof hist)/2;
+	if (bufs <= 0 || highpc == lowpc) {
+		printf("Profile not enabled\n");
+		done();
+	}
+	lowpc = (lowpc>>1) & 077777;
+	highpc = (highpc>>1) & 077777;
+	npe = nl;
+	initf(nf);
+	for (nname = 0; symsiz > 0; symsiz =- 12) {
+		for(i=0; i<12; i++)
+			buf->fname[i] = getc(ibuf);
+		if ((buf->flag | aflg) != 042)
+			continue;
+		buf->fvalue = (buf->fvalue>>1) & 077777;
+		npe->value = buf->fvalue;
+		for (i=0; i<8; i++)
+			npe->name[i] = buf->fname[i];
+		npe++;
+		nname++;
+	}
+	if (nname == 0) {
+		printf("No symbols: %s\n", namfil);
+		done();
+	}
+	npe->value = 077777;
+	npe++;
+	qsort(nl, nname, 14, &valcmp);
+	scale = (highpc-lowpc)/(bufs+0.0);
+	for (i=0; i<bufs; i++) {
+		ccnt = hist[i];
+		if (ccnt == 0)
+			continue;
+		time = ccnt;
+		if (ccnt<0)
+			time =+ 65536.;
+		totime =+ time;
+		pcl = lowpc + scale*i - 1;
+		pch = lowpc + scale*(i+1) - 1;
+		for (j=0; j<nname; j++) {
+			if (pch < nl[j].value)
+				break;
+			if (pcl >= nl[j+1].value)
+				continue;
+			overlap=(min(pch,nl[j+1].value)-max(pcl,nl[j].value));
+			nl[j].time =+ overlap*time/scale;
+		}
+	}
+	if (totime==0.0) {
+		printf("No time accumulated\n");
+		done();
+	}
+	printf("%.1f sec in system\n", totime/60.);
+	printf("    name %%time  ticks\n");
+	if (!lflg)
+		qsort(nl, nname, 14, &timcmp);
+	for (np = nl; np<npe-1; np++) {
+		if (np->time == 0.0 && !lflg)
+			break;
+		time = np->time/totime;
+		printf("%8.8s%6.1f%7.0f\n", np->name, 100*time, np->time);
+	}
+	done();
+}
+
+min(a, b)
+{
+	if (a<b)
+		return(a);
+	return(b);
+}
+
+max(a, b)
+{
+	if (a>b)
+		return(a);
+	return(b);
+}
+
+valcmp(p1, p2)
+struct nl *p1, *p2;
+{
+	return(p1->value - p2->value);
+}
+
+timcmp(p1, p2)
+struct nl *p1, *p2;
+{
+	float d;
+
+	d = p2->time - p1->time;
+	if (d > 0.0)
+		return(1);
+	if (d < 0.0)
+		return(-1);
+	return(0);
+}
+
+setup(p, s)
+char *p, *s;
+{
+	while (*p++ = *s++);
+}
+
+putchar(c)
+{
+
+	putc(c, obuf);
+}
+
+done()
+{
+
+	fflush(obuf);
+	exit();
+}
+
+initf(f)
+{
+
+	ibuf[0] = f;
+	ibuf[1] = 0;
+	ibuf[2] = 0;
+	ibuf[3] = 0;
+}
@@ -14,7 +14,7 @@ struct {
 	char name[8];
 	int  type;
 	char  *value;
-} nl[3];
+} nl[5];
 
 struct proc proc[NPROC];
 struct tty tty;
@@ -25,9 +25,13 @@ int	xflg;
 int	tflg;
 int	aflg;
 int	mem;
-int	swap;
+int	swap[NSWDEV];
+int	swdevs[2*NSWDEV];
+int	swplo;
+int	nswdev;
 
 int	stbuf[257];
+int	swbuf[512];
 int	ndev;
 char	devc[65];
 int	devl[65];
@@ -91,7 +95,9 @@ char **argv;
 		done();
 	}
 	setup(&nl[0], "_proc");
-	setup(&nl[1], "_swapdev");
+	setup(&nl[1], "_swdevs");
+	setup(&nl[2], "_swplo");
+	setup(&nl[3], "_nswdev");
 	nlist(argc>2? argv[2]:"/unix", nl);
 	if (nl[0].type==0) {
 		printf("No namelist\n");
@@ -105,7 +111,13 @@ char **argv;
 		done();
 	}
 	seek(mem, nl[1].value, 0);
-	read(mem, &nl[1].value, 2);
+	read(mem, swdevs, sizeof swdevs);
+	seek(mem, nl[2].value, 0);
+	read(mem, &swplo, 2);
+	seek(mem, nl[3].value, 0);
+	read(mem, &nswdev, 2);
+	if (nswdev < 1 || nswdev > NSWDEV)
+		nswdev = 1;
 	seek(mem, nl[0].value, 0);
 	read(mem, proc, sizeof proc);
 	getdev();
@@ -179,14 +191,15 @@ getdev()
 		printf("cannot open /dev\n");
 		done();
 	}
-	swap = -1;
+	for (i=0; i<NSWDEV; i++)
+		swap[i] = -1;
 	c = 0;
 
 loop:
 	i = read(f, dbuf, 512);
 	if(i <= 0) {
 		close(f);
-		if(swap < 0) {
+		if(swap[0] < 0) {
 			printf("no swap device\n");
 			done();
 		}
@@ -210,14 +223,13 @@ loop:
 			c++;
 			continue;
 		}
-		if(swap >= 0)
-			continue;
 		if(stat(p->dir_n, sbuf) < 0)
 			continue;
 		if((sbuf->iflags & 060000) != 060000)
 			continue;
-		if(sbuf->iaddr[0] == nl[1].value)
-			swap = open(p->dir_n, 0);
+		for(i=0; i<nswdev; i++)
+			if(sbuf->iaddr[0] == swdevs[2*i] && swap[i] < 0)
+				swap[i] = open(p->dir_n, 0);
 	}
 	goto loop;
 }
@@ -237,20 +249,28 @@ prcom(i)
 
 	baddr = 0;
 	laddr = 0;
+	mf = -1;
 	if (proc[i].p_flag&SLOAD) {
 		laddr = proc[i].p_addr;
 		mf = mem;
-	} else {
+	} else
 		baddr = proc[i].p_addr;
-		mf = swap;
-	}
 	laddr =+ proc[i].p_size - 8;
 	baddr =+ laddr>>3;
 	laddr = (laddr&07)<<6;
-	seek(mf, baddr, 3);
-	seek(mf, laddr, 1);
-	if (read(mf, stbuf, 512) != 512)
-		return(0);
+	if (mf >= 0) {
+		seek(mf, baddr, 3);
+		seek(mf, laddr, 1);
+		if (read(mf, stbuf, 512) != 512)
+			return(0);
+	} else {
+		if (swread(baddr, swbuf) || laddr && swread(baddr+1, swbuf+256))
+			return(0);
+		cp = swbuf;
+		cp =+ laddr;
+		for (cp1 = stbuf; cp1 < &stbuf[256]; )
+			*cp1++ = *cp++;
+	}
 	for (ip = &stbuf[256]; ip > &stbuf[0];) {
 		if (*--ip == -1) {
 			cp = ip+1;
@@ -278,6 +298,27 @@ prcom(i)
 	return(0);
 }
 
+/*
+ * Read swap block b, which is striped
+ * in SWINT block pieces across the
+ * nswdev swap devices.
+ */
+swread(b, buf)
+{
+	register n, d;
+
+	d = 0;
+	if (nswdev > 1) {
+		n = b - swplo;
+		d = (n/SWINT) % nswdev;
+		b = swplo + (n/SWINT/nswdev)*SWINT + n%SWINT;
+	}
+	if (swap[d] < 0)
+		return(1);
+	seek(swap[d], b, 3);
+	return(read(swap[d], buf, 512) != 512);
+}
+
 done()
 {
 
@@ -0,0 +1,111 @@
+#
+
+/*
+ *	qsortbm - comparisons and time qsort takes
+ *	on the inputs that hurt a plain quicksort
+ */
+
+#define	MAXN	4000
+
+int	n	2000;
+int	a[3*MAXN];
+int	nlo, nhi;		/* comparisons, as a long */
+char	*kinds[] { "sorted", "reverse", "equal", "pipe", "random", 0 };
+int	icmp();
+
+main(argc, argv)
+char **argv;
+{
+	register k, es;
+
+	if (argc > 1)
+		n = atoi(argv[1]);
+	if (n < 2 || n > MAXN) {
+		printf("Between 2 and %d elements\n", MAXN);
+		exit(1);
+	}
+	printf("%d elements\n", n);
+	printf("es   input   compares  per elt   secs\n");
+	for (es=2; es<=6; es =+ 4)
+		for (k=0; kinds[k]; k++) {
+			fill(k, es/2);
+			bench(k, es);
+		}
+}
+
+/*
+ * Keys in the first word,
+ * the rest of an element is ballast.
+ */
+fill(k, w)
+{
+	register i, v, *p;
+
+	p = a;
+	for (i=0; i<n; i++) {
+		switch (k) {
+		case 0:
+			v = i;
+			break;
+		case 1:
+			v = n-i;
+			break;
+		case 2:
+			v = 0;
+			break;
+		case 3:
+			v = i < n/2? i: n-i;
+			break;
+		default:
+			v = rand();
+		}
+		*p = v;
+		for (v=1; v<w; v++)
+			p[v] = i;
+		p =+ w;
+	}
+}
+
+bench(k, es)
+{
+	double un(), c;
+	int obt[6], tbuf[6];
+	register i, *p, w;
+
+	nlo = nhi = 0;
+	times(obt);
+	qsort(a, n, es, icmp);
+	times(tbuf);
+	w = es/2;
+	p = a;
+	for (i=1; i<n; i++, p =+ w)
+		if (p[0] > p[w]) {
+			printf("%s at es %d: out of order\n", kinds[k], es);
+			break;
+		}
+	c = un(nhi)*65536. + un(nlo);
+	printf("%2d %7s %10.0f %8.2f", es, kinds[k], c, c/n);
+	printf(" %6.2f\n", un(tbuf[0]-obt[0])/60.);
+}
+
+icmp(p, q)
+int *p, *q;
+{
+	if (++nlo == 0)
+		nhi++;
+	return(*p - *q);
+}
+
+/*
+ * The counts are unsigned.
+ */
+double
+un(a)
+{
+	double d;
+
+	d = a;
+	if (a < 0)
+		d =+ 65536.;
+	return(d);
+}
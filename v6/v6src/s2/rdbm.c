@@ -0,0 +1,304 @@
+#
+
+/*
+ *	rdbm - time cc and sort take with their
+ *	scratch files on the disk and on rd0
+ */
+
+char	*rd	"/dev/rd0";
+char	*csrc	"/usr/tmp/rbmc.c";
+char	*in	"/tmp/rbmi";
+char	*out	"/tmp/rbmo";
+int	nfunc;
+int	nline;
+
+char	*mkfsv[]	{ "/etc/mkfs", 0, 0, 0 };
+char	*mountv[] { "/etc/mount", 0, 0, 0 };
+char	*umountv[] { "/etc/umount", 0, 0 };
+char	*ccv[]	{ "/bin/cc", "-c", "-O", "rbmc.c", 0 };
+char	*sortv[]	{ "/bin/sort", "-o", 0, 0, 0 };
+
+struct {
+	char name[8];
+	int  type;
+	char  *value;
+} nl[3];
+
+struct sysstat {
+	int	ss_bread;
+	int	ss_bhit;
+	int	ss_read;
+	int	ss_write;
+	int	ss_iget;
+	int	ss_ihit;
+	int	ss_namei;
+	int	ss_dirent;
+	int	ss_syscall;
+	int	ss_stime;
+} old, new;
+
+struct ibuf {
+	int	idev;
+	int	inum;
+	int	iflags;
+	char	inl;
+	char	iuid;
+	char	igid;
+	char	isize0;
+	int	isize;
+	int	iaddr[8];
+	char	*ictime[2];
+	char	*imtime[2];
+};
+
+int	mem;
+int	rdsize;
+char	nblk[8];
+int	obuf[259];
+
+main(argc, argv)
+char **argv;
+{
+	struct ibuf sb;
+	int d;
+
+	setup(&nl[0], "_sysstat");
+	setup(&nl[1], "_rdsize");
+	nlist("/unix", nl);
+	if (nl[0].type==0 || nl[1].type==0) {
+		printf("No namelist\n");
+		exit(1);
+	}
+	if ((mem = open("/dev/mem", 0)) < 0) {
+		printf("No mem\n");
+		exit(1);
+	}
+	seek(mem, nl[1].value, 0);
+	read(mem, &rdsize, 2);
+	if (rdsize <= 0 || stat(rd, &sb) < 0) {
+		printf("No %s\n", rd);
+		exit(1);
+	}
+	d = sb.iaddr[0];
+	stat("/tmp", &sb);
+	if (sb.idev == d) {
+		printf("%s is mounted\n", rd);
+		exit(1);
+	}
+	stat("/usr/tmp", &sb);
+	if (sb.idev == d) {
+		printf("%s is mounted\n", rd);
+		exit(1);
+	}
+
+	/*
+	 * Keep the scratch files of both
+	 * commands well inside rd0.
+	 */
+	nfunc = rdsize/5;
+	nline = argc>1? atoi(argv[1]): rdsize*8;
+	if (nfunc <= 0 || nline <= 0) {
+		printf("Bad size\n");
+		exit(1);
+	}
+	itoa(rdsize, nblk);
+	mkfsv[1] = rd;
+	mkfsv[2] = nblk;
+	mountv[1] = rd;
+	umountv[1] = rd;
+	sortv[2] = out;
+	sortv[3] = in;
+	chdir("/usr/tmp");
+	genc();
+	gens();
+	printf("%d functions, %d lines, %s of %d blocks\n",
+		nfunc, nline, rd, rdsize);
+	printf("          real   user    sys  reads writes\n");
+	bench("cc", ccv, "/tmp");
+	bench("sort", sortv, "/usr/tmp");
+	unlink(csrc);
+	unlink("/usr/tmp/rbmc.o");
+	unlink(in);
+	unlink(out);
+}
+
+/*
+ * Run the command once as it is and once
+ * with a fresh rd0 mounted on dir,
+ * where it keeps its scratch files.
+ */
+bench(s, v, dir)
+char *s, **v, *dir;
+{
+	printf("%-4s rk", s);
+	time1(v);
+	mountv[2] = dir;
+	if (run(mkfsv) || run(mountv)) {
+		printf("Can't mount %s on %s\n", rd, dir);
+		exit(1);
+	}
+	printf("%-4s rd", s);
+	time1(v);
+	run(umountv);
+}
+
+/*
+ * Print the real and child times and the
+ * blocks moved.  Sync before and after,
+ * so the delayed writes are counted.
+ * Blocks moved to and from rd0 are
+ * counted as well, but take no waiting.
+ */
+time1(v)
+char **v;
+{
+	double un(), ticks(), r;
+	int obt[6], tbuf[6], otv[2], tv[2];
+
+	sync();
+	times(obt);
+	seek(mem, nl[0].value, 0);
+	read(mem, &old, sizeof old);
+	time(otv);
+	if (run(v))
+		printf(" %s failed", v[0]);
+	sync();
+	time(tv);
+	seek(mem, nl[0].value, 0);
+	read(mem, &new, sizeof new);
+	times(tbuf);
+	r = (un(tv[0])-un(otv[0]))*65536. + un(tv[1])-un(otv[1]);
+	printf("%7.0f", r);
+	printf("%7.1f", (ticks(&tbuf[2])-ticks(&obt[2]))/60.);
+	printf("%7.1f", (ticks(&tbuf[4])-ticks(&obt[4]))/60.);
+	printf("%7.0f", un(new.ss_read-old.ss_read));
+	printf("%7.0f\n", un(new.ss_write-old.ss_write));
+}
+
+run(v)
+char **v;
+{
+	int pid, status;
+
+	if ((pid = fork()) == 0) {
+		close(1);
+		open("/dev/null", 1);
+		execv(v[0], v);
+		exit(1);
+	}
+	if (pid == -1) {
+		printf("Try again\n");
+		exit(1);
+	}
+	while (wait(&status) != pid);
+	return(status);
+}
+
+/*
+ * nfunc functions of loops and arithmetic.
+ */
+genc()
+{
+	register i;
+
+	create(csrc);
+	for (i=0; i<nfunc; i++) {
+		put("f");
+		putn(i);
+		put("(a, b)\n{\n\tregister i, j;\n\tint x[10];\n\n");
+		put("\tj = a;\n\tfor (i=0; i<10; i++) {\n");
+		put("\t\tx[i] = j*b + i;\n\t\tif (x[i] > a)\n");
+		put("\t\t\tj =+ x[i]>>2;\n\t\telse\n\t\t\tj =- b;\n");
+		put("\t}\n\treturn(j);\n}\n\n");
+	}
+	fflush(obuf);
+	close(obuf[0]);
+}
+
+/*
+ * nline lines of two to seven words.
+ */
+gens()
+{
+	register i, j, k;
+
+	create(in);
+	for (i=0; i<nline; i++)
+		for (j = rand()%6+2; j > 0; j--) {
+			for (k = rand()%7+1; k > 0; k--)
+				putc('a'+rand()%26, obuf);
+			putc(j>1? ' ': '\n', obuf);
+		}
+	fflush(obuf);
+	close(obuf[0]);
+}
+
+create(f)
+char *f;
+{
+	if (fcreat(f, obuf) < 0) {
+		printf("Can't create %s\n", f);
+		exit(1);
+	}
+}
+
+put(s)
+char *s;
+{
+	while (*s)
+		putc(*s++, obuf);
+}
+
+putn(n)
+{
+	if (n >= 10)
+		putn(n/10);
+	putc('0'+n%10, obuf);
+}
+
+itoa(n, s)
+char *s;
+{
+	register char *p;
+	register i;
+
+	p = s;
+	for (i=10000; i>1; i=/10)
+		if (n >= i)
+			break;
+	for (; i; i=/10)
+		*p++ = '0' + n/i%10;
+	*p = 0;
+}
+
+/*
+ * Child times are long.
+ */
+double
+ticks(p)
+int *p;
+{
+	double un();
+
+	return(un(p[0])*65536. + un(p[1]));
+}
+
+/*
+ * The counts are unsigned.
+ */
+double
+un(a)
+{
+	double d;
+
+	d = a;
+	if (a < 0)
+		d =+ 65536.;
+	return(d);
+}
+
+setup(p, s)
+char *p, *s;
+{
+	while (*p++ = *s++);
+}
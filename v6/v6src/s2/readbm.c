@@ -0,0 +1,140 @@
+#
+
+/*
+ *	readbm - time read takes to move data
+ *	to user buffers at odd and even
+ *	addresses, in odd and even sizes
+ */
+
+char	*in	"/usr/tmp/rbmi";
+int	nblk	8;
+int	npass	50;
+int	sizes[]	{ 512, 511, 256, 255, 0 };
+
+struct {
+	char name[8];
+	int  type;
+	char  *value;
+} nl[2];
+
+struct sysstat {
+	int	ss_bread;
+	int	ss_bhit;
+	int	ss_read;
+	int	ss_write;
+	int	ss_iget;
+	int	ss_ihit;
+	int	ss_namei;
+	int	ss_dirent;
+	int	ss_syscall;
+	int	ss_stime;
+} old, new;
+
+int	mem;
+char	buf[514];
+
+main(argc, argv)
+char **argv;
+{
+	register i;
+
+	if (argc > 1)
+		npass = atoi(argv[1]);
+	if (npass <= 0) {
+		printf("Bad count\n");
+		exit(1);
+	}
+	setup(&nl[0], "_sysstat");
+	nlist("/unix", nl);
+	if (nl[0].type==0) {
+		printf("No namelist\n");
+		exit(1);
+	}
+	if ((mem = open("/dev/mem", 0)) < 0) {
+		printf("No mem\n");
+		exit(1);
+	}
+	gen();
+	printf("%d passes over %d blocks\n", npass, nblk);
+	printf("size addr  bread   bhit   read   user    sys   K/sec\n");
+	for (i=0; sizes[i]; i++) {
+		bench(sizes[i], 0);
+		bench(sizes[i], 1);
+	}
+	unlink(in);
+}
+
+gen()
+{
+	register i, f;
+
+	if ((f = creat(in, 0644)) < 0) {
+		printf("Can't create %s\n", in);
+		exit(1);
+	}
+	for (i=0; i<nblk; i++)
+		write(f, buf, 512);
+	close(f);
+}
+
+/*
+ * Read the file npass times, n bytes at
+ * a time, into buf, or buf+1 if odd.
+ * The file is small enough to stay in
+ * the buffers, so the system time is
+ * that of the calls and the moves;
+ * read counts any blocks that were not.
+ */
+bench(n, odd)
+{
+	double un(), s;
+	int obt[6], tbuf[6];
+	register f, p;
+
+	if ((f = open(in, 0)) < 0) {
+		printf("Can't open %s\n", in);
+		exit(1);
+	}
+	while (read(f, buf+odd, n) > 0);
+	seek(mem, nl[0].value, 0);
+	read(mem, &old, sizeof old);
+	times(obt);
+	for (p=0; p<npass; p++) {
+		seek(f, 0, 0);
+		while (read(f, buf+odd, n) > 0);
+	}
+	times(tbuf);
+	seek(mem, nl[0].value, 0);
+	read(mem, &new, sizeof new);
+	close(f);
+	s = un(tbuf[1]-obt[1])/60.;
+	printf("%4d %4s", n, odd? "odd": "even");
+	printf("%7.0f", un(new.ss_bread-old.ss_bread));
+	printf("%7.0f", un(new.ss_bhit-old.ss_bhit));
+	printf("%7.0f", un(new.ss_read-old.ss_read));
+	printf("%7.1f%7.1f", un(tbuf[0]-obt[0])/60., s);
+	if (s > 0.)
+		printf("%8.1f\n", npass*nblk/2./s);
+	else
+		printf("       -\n");
+}
+
+/*
+ * The counts are unsigned.
+ */
+double
+un(a)
+{
+	double d;
+
+	d = a;
+	if (a < 0)
+		d =+ 65536.;
+	return(d);
+}
+
+setup(p, s)
+char *p, *s;
+{
+	while (*p++ = *s++);
+}
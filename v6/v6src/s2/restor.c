@@ -2,6 +2,12 @@
 
 /*
  * restore from incremental dumps
+ *
+ * A table of contents, if the tape has one,
+ * names the files; x takes these names as well
+ * as i-numbers, and t lists them.  x goes
+ * straight to each file it wants, spacing
+ * over the records between on raw tape.
  */
 
 char	*dargv[]
@@ -32,6 +38,46 @@ int	wflg;
 int	cflg;
 char	file[10];
 int	ilist[100];
+int	itape[100];	/* where each is: tape, or -1 if not known */
+char	*iblk[100];	/* and block */
+int	tbuf[20*256];
+int	tbc;
+int	tbp;
+int	nrec;		/* blocks per tape record */
+int	tno;		/* tape being read, from 0 */
+char	*pta;		/* blocks asked for from it */
+char	*ata;		/* blocks read from it */
+int	ctflg;
+int	toc;
+#define	NTENT	23
+#define	TDIR	01
+#define	TLAST	02
+#define	NNAME	20
+struct	htab
+{
+	int	hino;
+	int	hpino;
+	char	hname[14];
+	int	htape;
+	char	*hblk;
+};
+struct
+{
+	int	t_nent;
+	int	t_flag;
+	struct	htab t_ent[NTENT];
+	int	t_pad[1];
+} tocb;
+struct	htab *dirs;	/* directories from the table of contents */
+int	ndir;
+int	*dhash;
+int	dhsize;
+char	*names[NNAME];	/* names asked for by x */
+int	nmatch[NNAME];
+int	nname;
+char	pbuf[256];
+int	pcom;
+int	xbuf[8*256];
 
 main(argc, argv)
 char **argv;
@@ -41,7 +87,7 @@ char **argv;
 	register struct inode *ip;
 	int i, com, sz, *q, l;
 
-	ifile = "/dev/mt0";
+	ifile = "/dev/rmt0";
 	if(argc == 1) {
 		argv = dargv;
 		for(argc = 1; dargv[argc]; argc++);
@@ -94,6 +140,7 @@ char **argv;
 	ddate[0] = *tap++;
 	ddate[1] = *tap++;
 	tsize = *tap++;
+	toc = *tap++;
 	i = size(0, isize*32);
 	talist = sbrk(i*512);
 	tap = talist;
@@ -134,6 +181,10 @@ case 't':
 	if(com)
 		printf("%l-\n", com);
 	printf("\n");
+	if(toc) {
+		pcom = 't';
+		rtoc();
+	}
 	exit();
 
 case 'r':
@@ -149,6 +200,8 @@ case 'r':
 	}
 	printf("last chance before scribbling on %s\n", ofile);
 	getchar();
+	if(toc)
+		rtoc();
 	dread(1, &sblock);
 	tap = talist;
 	for(i=0; i<sblock.s_isize; i++) {
@@ -190,9 +243,16 @@ case 'x':
 	tap = ilist;
 	while(argc > 1) {
 		i++;
-		sz = number(argv[1]);
+		key = argv[1];
 		argv++;
 		argc--;
+		if(*key < '0' || *key > '9') {
+			if(nname < NNAME)
+				names[nname++] = key; else
+				printf("too many names; %s ignored\n", key);
+			continue;
+		}
+		sz = number(key);
 		if(sz <= 0 || sz >=isize*16) {
 			printf("%l not in range\n", sz);
 			continue;
@@ -205,53 +265,302 @@ case 'x':
 			printf("%l does not exist\n", sz);
 			continue;
 		}
-		*tap++ = sz;
+		want(sz, -1, 0);
 	}
+	if(toc) {
+		pcom = 'x';
+		rtoc();
+	} else
+	if(nname)
+		printf("no table of contents; names ignored\n");
+	for(sz=0; sz<nname; sz++)
+		if(nmatch[sz] == 0)
+			printf("%s not on tape\n", names[sz]);
 	if(i != 0 && ilist[0] == 0)
 		exit();
+	if(ilist[0] != 0) {
+		mplace();
+		for(i=0; ilist[i]; i++) {
+			tseek(itape[i], iblk[i]);
+			xfile(ilist[i], talist[ilist[i]-1]-1);
+		}
+		exit();
+	}
 	tap = talist;
 	for(i=1; i<=isize*16; i++) {
-		if(ilist[0] != 0) {
-			for(sz=0; ilist[sz]; sz++)
-				if(ilist[sz] == i)
-					goto yes;
-			sz = *tap++;
-		no:
-			if(sz == -1)
-				sz = 0;
-			while(sz--)
-				tread(dbuf, 1);
-			continue;
-		}
-	yes:
 		sz = *tap++;
 		if(sz == 0 || sz == -1)
 			continue;
-		fo = dwait(i);
-		if(fo < 0)
-			goto no;
-		sz--;
-		sread(buf, 0);
-		ip = buf;
-		while(sz--) {
-			tread(dbuf, 0);
-			com = 512;
-			if(ip->i_size0 == 0 && ip->i_size1 < 512)
-				com = ip->i_size1;
-			write(fo, dbuf, com);
-			if(com > ip->i_size1)
-				ip->i_size0--;
-			ip->i_size1 =- com;
-		}
-		close(fo);
-		chmod(file, ip->i_mode);
-		chown(file, ip->i_uid);
+		xfile(i, sz-1);
 	}
 	exit();
 
 	}
 }
 
+/*
+ * Extract file ino, whose header
+ * is next on the tape, n blocks long.
+ * On a tape with a table of contents
+ * the header has the i-number after
+ * the i-node, so a wrong place is
+ * caught before anything is written.
+ */
+xfile(ino, n)
+{
+	register struct inode *ip;
+	register com, l;
+
+	sread(buf, 0);
+	if(toc && buf[16] != ino) {
+		printf("%l not where the tape says\n", ino);
+		return;
+	}
+	fo = dwait(ino);
+	if(fo < 0) {
+		while(n--)
+			tread(dbuf, 1);
+		return;
+	}
+	ip = buf;
+	l = 0;
+	while(n--) {
+		tread(&xbuf[l/2], 0);
+		com = 512;
+		if(ip->i_size0 == 0 && ip->i_size1 < 512)
+			com = ip->i_size1;
+		l =+ com;
+		if(l >= sizeof xbuf || n == 0) {
+			write(fo, xbuf, l);
+			l = 0;
+		}
+		if(com > ip->i_size1)
+			ip->i_size0--;
+		ip->i_size1 =- com;
+	}
+	close(fo);
+	chmod(file, ip->i_mode);
+	chown(file, ip->i_uid);
+}
+
+/*
+ * Add i-number i to those x restores;
+ * t and b say where it is, if known.
+ * The list is kept in i-number order,
+ * which is the order on the tape.
+ */
+want(i, t, b)
+char *b;
+{
+	register n, j;
+
+	for(n=0; ilist[n] && ilist[n] < i; n++)
+		;
+	if(ilist[n] == i) {
+		if(t >= 0) {
+			itape[n] = t;
+			iblk[n] = b;
+		}
+		return;
+	}
+	for(j=n; ilist[j]; j++)
+		;
+	if(j >= 99) {
+		printf("too many files; %l ignored\n", i);
+		return;
+	}
+	for(; j>n; j--) {
+		ilist[j] = ilist[j-1];
+		itape[j] = itape[j-1];
+		iblk[j] = iblk[j-1];
+	}
+	ilist[n] = i;
+	itape[n] = t;
+	iblk[n] = b;
+}
+
+/*
+ * Place from the map the files that
+ * the table of contents did not;
+ * the first file follows the table,
+ * where the tape is now.
+ */
+mplace()
+{
+	register *tap, n, t;
+	char *b;
+	int i;
+
+	for(n=0; ilist[n]; n++)
+		if(itape[n] < 0)
+			goto find;
+	return;
+
+find:
+	t = tno;
+	b = pta;
+	tap = talist;
+	n = 0;
+	for(i=1; ilist[n]; i++, tap++) {
+		if(*tap <= 0)
+			continue;
+		if(ilist[n] == i) {
+			if(itape[n] < 0) {
+				itape[n] = t;
+				iblk[n] = b;
+			}
+			n++;
+		}
+		b =+ *tap;
+		while(b >= tsize) {
+			b =- tsize;
+			t++;
+		}
+	}
+}
+
+/*
+ * Read the table of contents.
+ * The directories come first and are kept,
+ * to make path names for the rest; each
+ * name is then given to tname.
+ */
+rtoc()
+{
+	register struct htab *hp;
+	register i;
+
+	for(;;) {
+		tread(&tocb, 0);
+		if(tocb.t_flag&TDIR) {
+			hp = sbrk(tocb.t_nent * sizeof tocb.t_ent[0]);
+			if(hp == -1) {
+				printf("No memory\n");
+				exit();
+			}
+			if(ndir == 0)
+				dirs = hp;
+			copy(tocb.t_ent, hp, tocb.t_nent * sizeof tocb.t_ent[0]);
+			ndir =+ tocb.t_nent;
+		} else {
+			if(dhash == 0)
+				dhinit();
+			for(i=0; i<tocb.t_nent; i++)
+				if(tocb.t_ent[i].hino)
+					tname(&tocb.t_ent[i]);
+		}
+		if(tocb.t_flag&TLAST)
+			return;
+	}
+}
+
+/*
+ * Hash the directories by i-number,
+ * and hand each to tname.
+ */
+dhinit()
+{
+	register struct htab *hp;
+	register i;
+
+	dhsize = 2*ndir + 1;
+	dhash = sbrk(dhsize*2);
+	if(dhash == -1) {
+		printf("No memory\n");
+		exit();
+	}
+	for(i=0; i<dhsize; i++)
+		dhash[i] = 0;
+	for(hp = dirs; hp < &dirs[ndir]; hp++) {
+		for(i = (hp->hino&077777)%dhsize; dhash[i]; )
+			if(++i >= dhsize)
+				i = 0;
+		dhash[i] = hp-dirs+1;
+	}
+	for(hp = dirs; hp < &dirs[ndir]; hp++)
+		tname(hp);
+}
+
+dlook(ino)
+{
+	register i, j;
+
+	for(i = (ino&077777)%dhsize; j = dhash[i]; ) {
+		if(dirs[j-1].hino == ino)
+			return(&dirs[j-1]);
+		if(++i >= dhsize)
+			i = 0;
+	}
+	return(0);
+}
+
+/*
+ * List a name from the table of contents,
+ * or select its file if x asked for it.
+ */
+tname(hp)
+struct htab *hp;
+{
+	register char *p, *q;
+	register n;
+
+	if(pcom == 0)
+		return;
+	pathn(hp, pbuf, 0);
+	if(pcom == 't') {
+		printf("%l\t%s\n", hp->hino, pbuf);
+		return;
+	}
+	for(n=0; n<nname; n++) {
+		p = pbuf;
+		q = names[n];
+		while(*p == '/')
+			p++;
+		while(*q == '/')
+			q++;
+		while(*p == *q++)
+			if(*p++ == 0) {
+				nmatch[n]++;
+				if(hp->htape == 0 && hp->hblk == 0)
+					printf("%s not dumped\n", pbuf); else
+					want(hp->hino, hp->htape, hp->hblk);
+				break;
+			}
+	}
+}
+
+/*
+ * Put the path name of entry hp at p;
+ * return the end of it.
+ * lev bounds the depth, lest a bad
+ * table send it round in circles.
+ */
+pathn(hp, p, lev)
+struct htab *hp;
+char *p;
+{
+	register struct htab *dp;
+	register char *q;
+	register n;
+
+	q = p;
+	if(hp->hpino > 1 && lev < 16 && (dp = dlook(hp->hpino)) != 0)
+		q = pathn(dp, p, lev+1);
+	*q++ = '/';
+	for(n=0; n<14 && hp->hname[n]; n++)
+		*q++ = hp->hname[n];
+	*q = 0;
+	return(q);
+}
+
+copy(f, t, n)
+char *f, *t;
+{
+
+	while(n--)
+		*t++ = *f++;
+}
+
 dealoc(p)
 struct inode *p;
 {
@@ -395,15 +704,10 @@ tread(b, flag)
 int *b;
 {
 	register c;
-	static char *pta, *ata, ctflg;
 
-	if(pta++ >= tsize) {
-		pta = 1;
-		ata = 0;
-		close(fi);
-		otape();
-		ctflg++;
-	}
+	if(pta >= tsize)
+		tseek(tno+1, 0);
+	pta++;
 	if(flag)
 		return;
 	if(ctflg) {
@@ -416,14 +720,11 @@ int *b;
 		ctflg = 0;
 	}
 	ata++;
-	if(iflg)
+	if(pta-ata > tbc-tbp)
+		tskip(pta-ata);
 	for(; pta != ata; ata++)
-		read(fi, b, 512);
-	if(pta != ata) {
-		seek(fi, pta-ata, 4);
-		ata = pta;
-	}
-	if(read(fi, b, 512) != 512) {
+		rblock(b);
+	if(rblock(b)) {
 		printf("tape read error %l\n", ata-1);
 		if(!iflg)
 			exit();
@@ -432,6 +733,82 @@ int *b;
 	}
 }
 
+/*
+ * Make block b of tape t the next
+ * one tread reads.  The tape only
+ * goes forward.
+ */
+tseek(t, b)
+char *b;
+{
+
+	if(t < tno || t == tno && b < pta) {
+		printf("bad table of contents\n");
+		exit();
+	}
+	while(tno < t) {
+		close(fi);
+		otape();
+		tno++;
+		ctflg++;
+		pta = 0;
+		ata = 0;
+	}
+	pta = b;
+}
+
+/*
+ * Pass n blocks: those left in tbuf,
+ * then whole records, which raw tape
+ * spaces over without reading.
+ * What is left over is read.
+ */
+tskip(n)
+{
+	int v[3];
+
+	n =- tbc-tbp;
+	ata =+ tbc-tbp;
+	tbp = tbc;
+	if(nrec == 0)
+		return;
+	v[0] = n/nrec;
+	v[1] = 0;
+	v[2] = 0;
+	if(v[0] == 0 || stty(fi, v) < 0)
+		return;
+	ata =+ v[0]*nrec;
+}
+
+/*
+ * Copy the next block on the tape into b,
+ * reading another record when the last is used up.
+ * The records may be of any number of blocks.
+ */
+rblock(b)
+int *b;
+{
+	register i, *p, *q;
+
+	if(tbp >= tbc) {
+		tbp = 0;
+		tbc = read(fi, tbuf, sizeof tbuf) / 512;
+		if(tbc <= 0) {
+			tbc = 0;
+			return(1);
+		}
+		if(tbc > nrec)
+			nrec = tbc;
+	}
+	p = &tbuf[tbp*256];
+	q = b;
+	i = 256;
+	while(i--)
+		*q++ = *p++;
+	tbp++;
+	return(0);
+}
+
 number(s)
 char *s;
 {
@@ -461,6 +838,8 @@ otape()
 {
 	register char *p;
 
+	tbc = 0;
+	tbp = 0;
 	fi = open(ifile, 0);
 	if(fi < 0) {
 		printf("can not open %s\n", ifile);
@@ -1,5 +1,5 @@
 #define	L	512
-#define	N	7
+#define	NMERGE	32
 #define	C	20
 #define	MEM	(16*2048)
 #define NF	10
@@ -9,6 +9,24 @@ int	obuf[259];
 char	*file;
 char	*filep;
 int	nfiles;
+int	nmerge;
+int	nway;
+int	ltree[NMERGE];
+int	kflg;
+int	nproc	1;
+int	me;
+int	nbase;
+int	nlast;
+int	nextf;
+int	*hp;
+int	nheap;
+int	*tfree;
+int	*tend;
+int	nfree;
+int	more;
+int	nout;
+int	*lastout;
+int	sbuf[5+L];
 int	nlines;
 int	ntext;
 int	*lspace;
@@ -103,6 +121,13 @@ char **argv;
 					outfil = *++argv;
 				continue;
 
+			case 'p':
+				arg++;
+				if((nproc = number(&arg)) < 1)
+					nproc = 1;
+				arg--;
+				continue;
+
 			default:
 				field(++*argv,1);
 				break;
@@ -130,6 +155,11 @@ next:	;
 	}
 	if(eargc == 0)
 		eargv[eargc++] = "-";
+	if(nfields > 0 || fields[0].nflg)
+		kflg++;
+	if(nproc > eargc)
+		nproc = eargc;
+	nlast = eargc+676;
 
 	a = MEM;
 	i = lspace = sbrk(0);
@@ -137,10 +167,12 @@ next:	;
 		a =- 512;
 	brk(a =- 512);	/* for recursion */
 	a =- i;
-	nlines = ((a-L)>>1) & 077777;
+	nmerge = a / (2*L + 4 + sizeof obuf);	/* sizeof(struct merg) */
+	nlines = ((a-3*L)>>1) & 077777;
 	nlines =/ 5;
 	ntext = nlines*8;
 	tspace = lspace+nlines;
+	tend = tspace+ntext;
 	file = "/usr/tmp/stmXaa";
 loop:
 	filep = file;
@@ -163,17 +195,27 @@ loop:
 	}
 	close(a);
 	filep++;
+	for(a=0; a<NMERGE && (ltree[a] = dup(2)) >= 0; a++)
+		;
+	for(i=0; i<a; i++)
+		close(ltree[i]);
+	if(--a < nmerge)
+		nmerge = a;	/* one open file is the output */
+	if(nmerge < 2)
+		nmerge = 2;
 	if ((signal(2, 1) & 01) == 0)
 		signal(2, term);
-	nfiles = eargc;
+	nfiles = nbase = eargc;
 	if(!mflg) {
 		ibuf[0] = -1;
-		sort();
+		if(nproc > 1)
+			psort(); else
+			sort();
 		close(0);
 	}
-	for(a = mflg?0:eargc; a+N < nfiles; a=+N) {
+	for(a = mflg?0:eargc; a+nmerge < nfiles; a=+nmerge) {
 		newfile();
-		merge(a, a+N);
+		merge(a, a+nmerge);
 	}
 	if(a != nfiles) {
 		oldfile();
@@ -183,99 +225,408 @@ loop:
 	term();
 }
 
+/*
+ * Make sorted runs.  The first nmerge-1 are made the
+ * old way: memory is filled with lines and their keys,
+ * packed, and sorted by qsort.  If that is all the input
+ * it is the output, and otherwise those runs are merged
+ * in one pass.  Only when there are more are the rest
+ * made by replacement selection, which pays for its heap
+ * and records with longer runs.
+ */
 sort()
 {
+
+	hp = lspace;
+	tfree = tspace;
+	more = rdline();
+	if(more == 0) {
+		if(nproc > 1)
+			return;
+		oldfile();
+		fflush(obuf);
+		close(obuf[0]);
+		return;
+	}
+	for(nout = 0; nout < nmerge-1; nout++)
+		if(qrun() == 0)
+			return;
+	rsort();
+}
+
+/*
+ * Fill memory with lines as they come from rdline,
+ * each with its key, and write them sorted as a run,
+ * or as the output if they are all the input.
+ * Returns 0 at the end of the input.
+ */
+qrun()
+{
+	register int *p, *q, n;
+	char **lp, *cp;
+	int nw;
+
+	nw = kflg? 2: 1;
+	lp = lspace;
+	q = tspace;
+	while(more && lp+nw <= lspace+nlines && q+sbuf[2]-5 <= tend) {
+		*lp++ = cp = q;
+		if(kflg)
+			*lp++ = cp + (sbuf[4]-sbuf[3]);
+		p = &sbuf[5];
+		n = sbuf[2]-5;
+		while(n--)
+			*q++ = *p++;
+		more = rdline();
+	}
+	qsort(lspace, (lp-lspace)/nw, 2*nw, cmp);
+	if(more == 0 && nout == 0 && nfiles == eargc && nproc == 1)
+		oldfile(); else
+		newfile();
+	while(lp > lspace) {
+		lp =- nw;
+		cp = *lp;
+		do
+			putc(*cp, obuf);
+		while(*cp++ != '\n');
+	}
+	fflush(obuf);
+	close(obuf[0]);
+	return(more);
+}
+
+/*
+ * Make the rest of the runs by replacement selection.
+ * The lines in memory are kept in a heap, ordered by
+ * run and then by cmp; each line read replaces the one
+ * just written, and goes into the next run if it
+ * sorts before it.  On random input the runs come
+ * out about twice as long as memory holds.
+ *
+ * Each line is a record in tspace:
+ *	[0] its place in the heap, -1 if free, -2 if lastout
+ *	[1] its run
+ *	[2] its size in words
+ *	[3] the line, and
+ *	[4] the key, as cmp wants them
+ * then the line and its key.
+ */
+rsort()
+{
+	register int *r;
 	register char *cp;
-	register *lp, c;
-	int done;
-	int i;
-	int f;
+	int run;
 
-	done = 0;
-	i = 0;
-	do {
-		cp = tspace;
-		lp = lspace;
-		while(lp < lspace+nlines && cp < tspace+ntext) {
-			*lp++ = cp;
-			while((*cp++ = c = getc(ibuf)) != '\n') {
-				if(c >= 0) continue;
-				cp--;
-				close(ibuf[0]);
-				if(i < eargc) {
-					if((f = setfil(i++)) == 0)
-						ibuf[0] = 0;
-					else if(fopen(f, ibuf) < 0)
-						cant(f);
-				} else
-					break;
+	run = -1;
+	for(;;) {
+		while(more && nheap < nlines && room(sbuf[2])) {
+			r = tfree;
+			tfree =+ sbuf[2];
+			mvrec(sbuf, r);
+			r[1] = run;
+			if(run < 0 || lastout && cmp(&r[3], &lastout[3]) > 0)
+				r[1]++;
+			hput(nheap, r);
+			hup(nheap++);
+			more = rdline();
+		}
+		if(nheap == 0)
+			break;
+		r = hp[0];
+		if(r[1] != run) {
+			if(run >= 0) {
+				fflush(obuf);
+				close(obuf[0]);
 			}
-			if(c < 0) {
-				done++;
-				lp--;
+			newfile();
+			run = r[1];
+		}
+		cp = r[3];
+		do
+			putc(*cp, obuf);
+		while(*cp++ != '\n');
+		hput(0, hp[--nheap]);
+		if(nheap)
+			hdown(0);
+		if(lastout) {
+			lastout[0] = -1;
+			nfree =+ lastout[2];
+		}
+		lastout = r;
+		r[0] = -2;
+	}
+	fflush(obuf);
+	close(obuf[0]);
+}
+
+/*
+ * Make the runs with nproc processes, each
+ * sorting its share of the input files into its
+ * own range of temporary names, then number
+ * the runs consecutively.
+ */
+psort()
+{
+	register i, k, n;
+	int per, pid;
+	char name[20];
+
+	per = 676/nproc;
+	for(k=0; k<nproc; k++) {
+		pid = fork();
+		if(pid == 0) {
+			me = k;
+			nfiles = nbase = eargc + k*per;
+			nlast = nbase+per;
+			sort();
+			exit(0);
+		}
+		if(pid < 0) {
+			mess("Can't fork\n");
+			term();
+		}
+	}
+	nfiles = eargc + nproc*per;
+	n = 0;
+	while(wait(&i) != -1)
+		n =| i;
+	if(n)
+		term();
+	n = eargc;
+	for(k=0; k<nproc; k++)
+		for(i = eargc+k*per; i < eargc+(k+1)*per; i++) {
+			if(stat(setfil(i), lspace) < 0)
 				break;
+			if(i != n) {
+				for(pid=0; name[pid] = file[pid]; pid++)
+					;
+				unlink(setfil(n));
+				link(name, setfil(n));
+				unlink(name);
 			}
+			n++;
 		}
-		qsort(lspace, lp-lspace, 2, cmp);
-		if(done == 0 || nfiles != eargc)
-			newfile(); else
-			oldfile();
-		while(lp > lspace) {
-			cp = *--lp;
-			do
-				putc(*cp, obuf);
-			while(*cp++ != '\n');
+	nfiles = n;
+}
+
+/*
+ * Read the next line of this process's
+ * share of the input into the record at sbuf.
+ * Returns 0 at the end.  The line and its key
+ * must fit in 2*L bytes, as they must in merge.
+ */
+rdline()
+{
+	register char *cp;
+	register c;
+	char *lp;
+	int f;
+
+	cp = &sbuf[5];
+	sbuf[0] = -1;
+	sbuf[3] = cp;
+	while((*cp++ = c = getc(ibuf)) != '\n') {
+		if(c >= 0) {
+			if(cp < &sbuf[5+L])
+				continue;
+			mess("Line too long\n");
+			term();
 		}
-		fflush(obuf);
-		close(obuf[0]);
-	} while(done == 0);
+		cp--;
+		close(ibuf[0]);
+		while(nextf < eargc && nextf%nproc != me)
+			nextf++;
+		if(nextf >= eargc)
+			return(0);
+		if((f = setfil(nextf++)) == 0)
+			ibuf[0] = 0;
+		else if(fopen(f, ibuf) < 0)
+			cant(f);
+	}
+	if(kflg) {
+		sbuf[4] = cp;
+		cp = mkey(sbuf[3], cp, &sbuf[5+L]);
+	}
+	lp = sbuf[3];
+	c = cp - lp;
+	sbuf[2] = 5 + (c+1)/2;
+	return(1);
+}
+
+/*
+ * Is there room at tfree for n words?
+ * Holes left by lines written are squeezed
+ * out only once they add up to a quarter of
+ * tspace, or when the heap is empty.  Nfree
+ * counts words, ntext bytes.
+ */
+room(n)
+{
+
+	if(tfree+n <= tend)
+		return(1);
+	if(nfree < ntext/8 && nheap > 0)
+		return(0);
+	compact();
+	if(tfree+n <= tend)
+		return(1);
+	if(nheap == 0) {
+		mess("Line too long\n");
+		term();
+	}
+	return(0);
+}
+
+compact()
+{
+	register int *p, *q, n;
+
+	p = q = tspace;
+	while(p < tfree) {
+		n = p[2];
+		if(p[0] != -1) {
+			if(p != q)
+				mvrec(p, q);
+			q =+ n;
+		}
+		p =+ n;
+	}
+	tfree = q;
+	nfree = 0;
+}
+
+/*
+ * Move the record at f to t,
+ * and the pointers to and in it.
+ */
+mvrec(f, t)
+int *f, *t;
+{
+	register int *p, *q, n;
+	int d;
+
+	d = t;
+	n = f;
+	d =- n;
+	f[3] =+ d;
+	if(kflg)
+		f[4] =+ d;
+	p = f;
+	q = t;
+	n = f[2];
+	while(n--)
+		*q++ = *p++;
+	if(t[0] >= 0)
+		hp[t[0]] = t;
+	else if(t[0] == -2)
+		lastout = t;
+}
+
+hput(i, r)
+int *r;
+{
+
+	hp[i] = r;
+	r[0] = i;
+}
+
+hup(ai)
+{
+	register i, j, *r;
+
+	i = ai;
+	r = hp[i];
+	while(i > 0 && hbefore(r, hp[j = (i-1)/2])) {
+		hput(i, hp[j]);
+		i = j;
+	}
+	hput(i, r);
+}
+
+/*
+ * Move the record at the top down to its place.
+ * It comes from the bottom and mostly goes back
+ * there, so the lesser children are moved up all
+ * the way to a leaf, one compare a level, and the
+ * record is then moved up from the leaf.
+ */
+hdown(ai)
+{
+	register i, j, *r;
+
+	i = ai;
+	r = hp[i];
+	while((j = 2*i+1) < nheap) {
+		if(j+1 < nheap && hbefore(hp[j+1], hp[j]))
+			j++;
+		hput(i, hp[j]);
+		i = j;
+	}
+	hput(i, r);
+	hup(i);
+}
+
+/*
+ * Does record x come out before record y?
+ */
+hbefore(x, y)
+int *x, *y;
+{
+
+	if(x[1] != y[1])
+		return(x[1] < y[1]);
+	return(cmp(&x[3], &y[3]) > 0);
 }
 
 struct merg
 {
-	char	l[L];
+	char	*ml;		/* the line, and the */
+	char	*mk;		/* key after it, for cmp */
+	char	l[2*L];
 	int	b[259];
 };
 
+/*
+ * Merge files a through b-1 with a tree of losers:
+ * ibuf[i] is the current line of input i, or 0
+ * when it is used up; ltree[0] is the input whose
+ * line comes next, and each other ltree[t] the input
+ * that lost at node t, so a new line from the winner
+ * need only be compared on the way to the root.
+ */
 merge(a, b)
 {
 	register struct merg *p;
 	register char *cp;
 	register i;
-	struct { int *ip;};
 	int f;
-	int j;
 
 	p = lspace;
-	j = 0;
-	for(i=a; i<b; i++) {
-		f = setfil(i);
+	nway = b-a;
+	for(i=0; i<nway; i++) {
+		f = setfil(a+i);
 		if(f == 0)
 			p->b[0] = dup(0);
 		else if(fopen(f, p->b) < 0)
 			cant(f);
-		ibuf[j] = p;
-		if(!rline(p)) j++;
+		p->ml = p->l;
+		ibuf[i] = p;
+		if(rline(p))
+			ibuf[i] = 0;
 		p++;
 	}
-	i = j;
-	qsort(ibuf, i, 2, cmp);
-	if(i > 0) for(;;) {
-		cp = ibuf[i-1];
+	for(i=0; i<nway; i++)
+		ltree[i] = nway;
+	for(i=nway-1; i>=0; i--)
+		adjust(i);
+	while(p = ibuf[i = ltree[0]]) {
+		cp = p->l;
 		do
 			putc(*cp, obuf);
 		while(*cp++ != '\n');
-		if(rline(ibuf[i-1])) {
-			i--;
-			if(i == 0)
-				break;
-		}
-		cp = &ibuf[i];
-		while (--cp.ip > ibuf && cmp(cp.ip, cp.ip-1) < 0) {
-			p = *cp.ip;
-			*cp.ip = *(cp.ip-1);
-			*(cp.ip-1) = p;
-		}
+		if(rline(p))
+			ibuf[i] = 0;
+		adjust(i);
 	}
 	p = lspace;
 	for(i=a; i<b; i++) {
@@ -288,6 +639,43 @@ merge(a, b)
 	close(obuf[0]);
 }
 
+/*
+ * Carry input s up the tree to the root.
+ */
+adjust(s)
+{
+	register t, w, x;
+
+	w = s;
+	for(t = (w+nway)>>1; t > 0; t =>> 1)
+		if(before(ltree[t], w)) {
+			x = ltree[t];
+			ltree[t] = w;
+			w = x;
+		}
+	ltree[0] = w;
+}
+
+/*
+ * Does the line of input x come out
+ * before that of input y?  Input nway
+ * stands for a line before all others,
+ * a used up input for one after all.
+ */
+before(x, y)
+{
+
+	if(x == nway)
+		return(1);
+	if(y == nway)
+		return(0);
+	if(ibuf[x] == 0)
+		return(0);
+	if(ibuf[y] == 0)
+		return(1);
+	return(cmp(ibuf[x], ibuf[y]) > 0);
+}
+
 rline(mp)
 struct merg *mp;
 {
@@ -300,14 +688,26 @@ struct merg *mp;
 		c = getc(bp);
 		if(c < 0)
 			return(1);
+		if(cp >= &mp->l[2*L]) {
+			mess("Line too long\n");
+			term();
+		}
 		*cp++ = c;
 	} while(c != '\n');
+	if(kflg) {
+		mp->mk = cp;
+		mkey(mp->l, cp, &mp->l[2*L]);
+	}
 	return(0);
 }
 
 newfile()
 {
 
+	if(nfiles >= nlast) {
+		mess("Too many temps\n");
+		term();
+	}
 	if(fcreat(setfil(nfiles), obuf) < 0) {
 		mess("Can't create temp\n");
 		term();
@@ -356,7 +756,7 @@ term()
 
 	if(nfiles == eargc)
 		nfiles++;
-	for(i=eargc; i<nfiles; i++)
+	for(i=nbase; i<nfiles; i++)
 		unlink(setfil(i));
 	exit(error);
 }
@@ -374,6 +774,20 @@ int *i, *j;
 	char *ipa, *ipb, *jpa, *jpb;
 	struct field *fp;
 
+	if(kflg) {
+		pa = i[1];
+		pb = j[1];
+		a = (pa[0]&0377) | (pa[1]<<8);
+		b = (pb[0]&0377) | (pb[1]<<8);
+		if(b < a)
+			a = b;
+		pa =+ 2;
+		pb =+ 2;
+		while(a--)
+			if(*pa++ != *pb++)
+				return((pb[-1]&0377) - (pa[-1]&0377));
+		goto line;
+	}
 	for(k = nfields>0; k<=nfields; k++) {
 		fp = &fields[k];
 		pa = *i;
@@ -450,6 +864,7 @@ loop:
 			goto loop;
 		return(sa*fp->rflg);
 	}
+line:
 	pa = *i;
 	pb = *j;
 	while(*pa != '\n') {
@@ -465,6 +880,117 @@ loop:
 	return(*pb != '\n');
 }
 
+/*
+ * Make at kp the key of line lp: a count of
+ * bytes, then for each field the bytes that,
+ * compared unsigned, order lines as the field
+ * would in cmp.  Returns the end of the key,
+ * which must not pass ke.
+ *
+ * A text field is its characters through the
+ * translation table, plus one, with those ignored
+ * left out, then 0.  A field sorted in reverse
+ * is complemented.
+ */
+mkey(lp, kp, ke)
+char *lp, *kp, *ke;
+{
+	register char *p, *k, *q;
+	char *la, *code, *ignore;
+	int i;
+	struct field *fp;
+
+	k = kp+2;
+	for(i = nfields>0; i<=nfields; i++) {
+		fp = &fields[i];
+		if(k + (kp-lp) + 3 > ke) {	/* no field is longer */
+			mess("Line too long\n");
+			term();
+		}
+		p = lp;
+		la = -1;
+		if(i) {
+			la = skip(p, fp, 1);
+			p = skip(p, fp, 0);
+		}
+		q = k;
+		if(fp->nflg)
+			k = nkey(p, la, k);
+		else {
+			code = fp->code;
+			ignore = fp->ignore;
+			for(; p<la && *p!='\n'; p++)
+				if(*p >= 0 && !ignore[*p])
+					*k++ = code[*p] + 1;
+			*k++ = 0;
+		}
+		if(fp->rflg < 0)
+			while(q < k)
+				*q++ =^ 0377;
+	}
+	i = k - kp - 2;
+	kp[0] = i;
+	kp[1] = i>>8;
+	return(k);
+}
+
+/*
+ * The key of a numeric field is 2 for zero;
+ * otherwise 3, the number of integer digits
+ * less leading zeros, those digits, the
+ * fraction less trailing zeros, and 0.
+ * A negative number is the same
+ * complemented after a leading 1,
+ * if its integer part is not zero.
+ * The sign of a fraction is dropped,
+ * so that -x and x tie, as they did
+ * when cmp compared the digits.
+ */
+nkey(ap, la, ak)
+char *ap, *la, *ak;
+{
+	register char *p, *k, *e;
+	char *q;
+	int neg;
+
+	p = ap;
+	k = ak;
+	while(blank(*p))
+		p++;
+	neg = 0;
+	if(*p == '-') {
+		p++;
+		neg++;
+	}
+	while(p<la && *p=='0')
+		p++;
+	for(e = p; e<la && digit(*e); e++)
+		;
+	q = k;
+	*k++ = 3;
+	*k++ = e-p;
+	while(p < e)
+		*k++ = *p++;
+	if(*p == '.')
+		p++;
+	e = k;
+	while(p<la && digit(*p))
+		if((*k++ = *p++) != '0')
+			e = k;
+	k = e;
+	if(k == q+2) {
+		*q = 2;
+		return(q+1);
+	}
+	*k++ = 0;
+	if(neg && q[1]) {
+		*q = 1;
+		for(p = q+1; p < k; p++)
+			*p =^ 0377;
+	}
+	return(k);
+}
+
 skip(pp, fp, j)
 struct field *fp;
 char *pp;
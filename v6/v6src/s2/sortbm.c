@@ -0,0 +1,171 @@
+#
+
+/*
+ *	sortbm - passes sort makes over its temporary files,
+ *	and their traffic, for inputs of several sizes
+ */
+
+char	*in	"/usr/tmp/sbmi";
+char	*out	"/usr/tmp/sbmo";
+int	sizes[]	{ 2000, 8000, 32000, 0 };
+
+struct {
+	char name[8];
+	int  type;
+	char  *value;
+} nl[2];
+
+struct sysstat {
+	int	ss_bread;
+	int	ss_bhit;
+	int	ss_read;
+	int	ss_write;
+	int	ss_iget;
+	int	ss_ihit;
+	int	ss_namei;
+	int	ss_dirent;
+	int	ss_syscall;
+	int	ss_stime;
+} old, new;
+
+int	mem;
+int	obuf[259];
+int	nc, nb;
+
+main(argc, argv)
+char **argv;
+{
+	int i;
+
+	setup(&nl[0], "_sysstat");
+	nlist("/unix", nl);
+	if (nl[0].type==0) {
+		printf("No namelist\n");
+		exit(1);
+	}
+	if ((mem = open("/dev/mem", 0)) < 0) {
+		printf("No mem\n");
+		exit(1);
+	}
+	printf("  lines blocks  reads writes passes   temp   user    sys\n");
+	if (argc > 1)
+		for (i=1; i<argc; i++)
+			bench(atoi(argv[i]));
+	else
+		for (i=0; sizes[i]; i++)
+			bench(sizes[i]);
+	unlink(in);
+	unlink(out);
+}
+
+/*
+ * Sort n lines of random words and
+ * print the blocks moved meanwhile.
+ * The runs and every merge but the last
+ * are written to temporary files once
+ * and read back once; the output is
+ * written once more.
+ */
+bench(n)
+{
+	double un(), ticks(), b, w;
+	int tbuf[6], obt[6];
+
+	b = gen(n);
+	sync();
+	times(obt);
+	seek(mem, nl[0].value, 0);
+	read(mem, &old, sizeof old);
+	run();
+	sync();
+	seek(mem, nl[0].value, 0);
+	read(mem, &new, sizeof new);
+	times(tbuf);
+	w = un(new.ss_write-old.ss_write);
+	printf("%7d%7.0f", n, b);
+	printf("%7.0f%7.0f", un(new.ss_read-old.ss_read), w);
+	printf("%7.2f%7.0f", (w-b)/b, w-b);
+	printf("%7.1f", (ticks(&tbuf[2])-ticks(&obt[2]))/60.);
+	printf("%7.1f\n", (ticks(&tbuf[4])-ticks(&obt[4]))/60.);
+}
+
+/*
+ * n lines of two to seven words;
+ * return the blocks of the file.
+ */
+gen(n)
+{
+	register i, j, k;
+
+	if (fcreat(in, obuf) < 0) {
+		printf("Can't create %s\n", in);
+		exit(1);
+	}
+	nc = nb = 0;
+	for (i=0; i<n; i++)
+		for (j = rand()%6+2; j > 0; j--) {
+			for (k = rand()%7+1; k > 0; k--)
+				put('a'+rand()%26);
+			put(j>1? ' ': '\n');
+		}
+	fflush(obuf);
+	close(obuf[0]);
+	return(nb + (nc>0));
+}
+
+put(c)
+{
+	putc(c, obuf);
+	if (++nc >= 512) {
+		nc = 0;
+		nb++;
+	}
+}
+
+run()
+{
+	int pid, status;
+
+	if ((pid = fork()) == 0) {
+		execl("/bin/sort", "sort", "-o", out, in, 0);
+		printf("Can't find /bin/sort\n");
+		exit(1);
+	}
+	if (pid == -1) {
+		printf("Try again\n");
+		exit(1);
+	}
+	while (wait(&status) != pid);
+}
+
+/*
+ * Child times are long.
+ */
+double
+ticks(p)
+int *p;
+{
+	double un();
+
+	return(un(p[0])*65536. + un(p[1]));
+}
+
+/*
+ * The counts are unsigned.
+ */
+double
+un(a)
+{
+	double d;
+
+	d = a;
+	if (a < 0)
+		d =+ 65536.;
+	return(d);
+}
+
+setup(p, s)
+char *p, *s;
+{
+	while (*p++ = *s++);
+}
@@ -0,0 +1,23 @@
+/ C library -- map
+
+/ error = map(file, addr);
+
+map = 29.
+
+.globl	_map, cerror
+
+_map:
+	mov	r5,-(sp)
+	mov	sp,r5
+	mov	4(r5),r0
+	mov	6(r5),0f
+	sys	0; 9f
+	bec	1f
+	jmp	cerror
+1:
+	clr	r0
+	mov	(sp)+,r5
+	rts	pc
+.data
+9:
+	sys	map; 0:..
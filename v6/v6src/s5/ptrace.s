@@ -1,6 +1,7 @@
 / ptrace -- C library
 
 /	result = ptrace(req, pid, addr, data);
+/	count = ptrace(req, pid, addr, buf, count);	block requests
 
 ptrace = 26.
 indir = 0
@@ -15,6 +16,7 @@ _ptrace:
 	mov	6.(r5),0f+0
 	mov	8.(r5),0f+2
 	mov	10.(r5),r0
+	mov	12.(r5),r1
 	clr	_errno
 	sys	indir; 9f
 	bec	1f
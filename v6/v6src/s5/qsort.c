@@ -1,18 +1,37 @@
 
+/*
+ * Quicksort, splitting about the median of the first,
+ * middle and last elements into those less, equal and
+ * greater; short stretches are finished by insertion,
+ * and a stretch split too often is heapsorted, so no
+ * input takes more than order n log n comparisons.
+ */
+
+#define	QSMALL	7	/* insertion sort this many or fewer */
+
 int	(*qscmp)();
 int	qses;
+int	qsw;		/* elements are aligned words */
+struct	{ int qsword; };
 
 qsort(a, n, es, fc)
 char *a;
 int n, es;
 int (*fc)();
 {
+	register m, d;
+
 	qscmp = fc;
 	qses = es;
-	qs1(a, a+n*es);
+	m = a;
+	qsw = es == 2 && (m&1) == 0;
+	d = 0;
+	for(m = n; m > 1; m =>> 1)
+		d =+ 2;
+	qs1(a, a+n*es, d);
 }
 
-qs1(a, l)
+qs1(a, l, d)
 char *a, *l;
 {
 	register char *i, *j, *es;
@@ -25,12 +44,27 @@ char *a, *l;
 start:
 	if((n=l-a) <= es)
 		return;
+	if(n <= QSMALL*es) {
+		qsins(a, l);
+		return;
+	}
+	if(--d < 0) {
+		qsheap(a, l);
+		return;
+	}
 
 
 	n = ((n/(2*es))*es) & 077777;
 	hp = lp = a+n;
 	i = a;
 	j = l-es;
+	if((*qscmp)(i, lp) > 0)
+		qsexc(i, lp);
+	if((*qscmp)(lp, j) > 0) {
+		qsexc(lp, j);
+		if((*qscmp)(i, lp) > 0)
+			qsexc(i, lp);
+	}
 
 
 	for(;;) {
@@ -69,10 +103,10 @@ loop:
 
 		if(i == lp) {
 			if(lp-a >= l-hp) {
-				qs1(hp+es, l);
+				qs1(hp+es, l, d);
 				l = lp;
 			} else {
-				qs1(a, lp);
+				qs1(a, lp, d);
 				a = hp+es;
 			}
 			goto start;
@@ -84,15 +118,70 @@ loop:
 	}
 }
 
+qsins(a, l)
+char *a, *l;
+{
+	register char *i, *j, *es;
+
+	es = qses;
+	for(i = a+es; i < l; i =+ es)
+		for(j = i; j > a && (*qscmp)(j-es, j) > 0; j =- es)
+			qsexc(j-es, j);
+}
+
+/*
+ * Heapsort, with element k (from 1) at a+(k-1)*es.
+ */
+qsheap(a, l)
+char *a, *l;
+{
+	register n, k;
+
+	n = (l-a)/qses;
+	for(k = n/2; k > 0; k--)
+		qssift(a, k, n);
+	for(k = n; k > 1; k--) {
+		qsexc(a, a+(k-1)*qses);
+		qssift(a, 1, k-1);
+	}
+}
+
+qssift(a, k, n)
+char *a;
+{
+	register char *p, *q;
+	register j;
+
+	p = a+(k-1)*qses;
+	while((j = 2*k) <= n) {
+		q = a+(j-1)*qses;
+		if(j < n && (*qscmp)(q, q+qses) < 0) {
+			q =+ qses;
+			j++;
+		}
+		if((*qscmp)(p, q) >= 0)
+			break;
+		qsexc(p, q);
+		p = q;
+		k = j;
+	}
+}
+
 qsexc(i, j)
 char *i, *j;
 {
 	register char *ri, *rj, c;
 	int n;
 
-	n = qses;
 	ri = i;
 	rj = j;
+	if(qsw) {
+		n = ri->qsword;
+		ri->qsword = rj->qsword;
+		rj->qsword = n;
+		return;
+	}
+	n = qses;
 	do {
 		c = *ri;
 		*ri++ = *rj;
@@ -107,10 +196,17 @@ char *i, *j, *k;
 	char	c;
 	int	n;
 
-	n = qses;
 	ri = i;
 	rj = j;
 	rk = k;
+	if(qsw) {
+		n = ri->qsword;
+		ri->qsword = rk->qsword;
+		rk->qsword = rj->qsword;
+		rj->qsword = n;
+		return;
+	}
+	n = qses;
 	do {
 		c = *ri;
 		*ri++ = *rk;
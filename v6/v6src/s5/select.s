@@ -0,0 +1,30 @@
+/ select -- C library
+
+/	ready = select(&rmask, &wmask, seconds);
+/
+/	the masks are replaced by those of the
+/	ready files; ready is 0 if time ran out
+
+select = 27.
+
+.globl	_select, cerror
+
+_select:
+	mov	r5,-(sp)
+	mov	sp,r5
+	mov	*4(r5),0f
+	mov	*6(r5),0f+2
+	mov	8.(r5),r0
+	sys	0; 9f
+	bec	1f
+	jmp	cerror
+1:
+	mov	r0,*4(r5)
+	mov	r1,*6(r5)
+	bis	r1,r0
+	mov	(sp)+,r5
+	rts	pc
+
+.data
+9:
+	sys	select; 0: .=.+4